@@ -3,18 +3,170 @@
 
 #include "CTRLPawnStateTreeComponent.h"
 
+#include "StateTree.h"
 #include "StateTreeExecutionContext.h"
 
 #include "CTRLStateTree/CTRLPawnStateTreeSchema.h"
 #include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+#include "CTRLStateTree/CTRLStateTreeTimings.h"
+#include "CTRLStateTree/Utils/CTRLPawnStateTreeTickSubsystem.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeInstanceDataPoolSubsystem.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeLoadingSubsystem.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeLODSubsystem.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeSleepSubsystem.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeStartupSubsystem.h"
+
+#include "Engine/World.h"
 
 #include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerController.h"
 
+#include "Misc/ScopeRWLock.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "TimerManager.h"
+
+#include "UObject/ObjectKey.h"
+
 #include "VisualLogger/VisualLogger.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLPawnStateTreeComponent)
 
+DECLARE_CYCLE_STAT(TEXT("Start Logic"), STAT_CTRLStateTree_StartLogic, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Tick"), STAT_CTRLStateTree_Tick, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Possession Change"), STAT_CTRLStateTree_PossessionChange, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Stop Logic"), STAT_CTRLStateTree_StopLogic, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Collect External Data"), STAT_CTRLStateTree_CollectExternalData, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("External Data Resolves"), STAT_CTRLStateTree_ExternalDataResolves, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Avoided Possession Restarts"), STAT_CTRLStateTree_AvoidedRestarts, STATGROUP_CTRLStateTree);
+
+namespace CTRL::PawnStateTree::Tags
+{
+	UE_DEFINE_GAMEPLAY_TAG_COMMENT(Event_ContextChanged, "CTRL.StateTree.Event.ContextChanged", "A pawn StateTree context actor was swapped without restarting the tree");
+}
+
+namespace CTRL::PawnStateTree::Private
+{
+	// Context data handles, resolved once per StateTree asset instead of name lookups on every SetContextRequirements.
+	struct FContextDataHandles
+	{
+		FStateTreeExternalDataHandle OwnerActor;
+		FStateTreeExternalDataHandle ControllerActor;
+		FStateTreeExternalDataHandle PawnActor;
+	};
+
+	struct FSchemaValidationKey
+	{
+		TObjectKey<UStateTree> StateTree;
+		TObjectKey<UClass> OwnerClass;
+		TObjectKey<UClass> ControllerClass;
+		TObjectKey<UClass> PawnClass;
+		bool bRequiresController = false;
+		bool bRequiresPawn = false;
+
+		friend bool operator==(FSchemaValidationKey const& Lhs, FSchemaValidationKey const& Rhs)
+		{
+			return Lhs.StateTree == Rhs.StateTree
+				&& Lhs.OwnerClass == Rhs.OwnerClass
+				&& Lhs.ControllerClass == Rhs.ControllerClass
+				&& Lhs.PawnClass == Rhs.PawnClass
+				&& Lhs.bRequiresController == Rhs.bRequiresController
+				&& Lhs.bRequiresPawn == Rhs.bRequiresPawn;
+		}
+
+		friend uint32 GetTypeHash(FSchemaValidationKey const& Arg)
+		{
+			uint32 Hash = HashCombine(GetTypeHash(Arg.StateTree), GetTypeHash(Arg.OwnerClass));
+			Hash = HashCombine(Hash, GetTypeHash(Arg.ControllerClass));
+			Hash = HashCombine(Hash, GetTypeHash(Arg.PawnClass));
+			Hash = HashCombine(Hash, GetTypeHash(Arg.bRequiresController));
+			Hash = HashCombine(Hash, GetTypeHash(Arg.bRequiresPawn));
+			return Hash;
+		}
+	};
+
+	// read from worker threads by the parallel batched tick
+	FRWLock ContextCacheLock;
+	TMap<TObjectKey<UStateTree>, FContextDataHandles> ContextDataHandlesCache;
+	TMap<FSchemaValidationKey, bool> SchemaValidationCache;
+	// for trees without compiled traits, e.g. not recompiled yet
+	TMap<TObjectKey<UStateTree>, FCTRLStateTreeTraits> TraitsCache;
+
+	FContextDataHandles GetContextDataHandles(UStateTree const* StateTree)
+	{
+		{
+			FReadScopeLock ReadLock(ContextCacheLock);
+			if (FContextDataHandles const* Handles = ContextDataHandlesCache.Find(StateTree))
+			{
+				return *Handles;
+			}
+		}
+
+		FContextDataHandles Handles;
+		for (FStateTreeExternalDataDesc const& Desc : StateTree->GetContextDataDescs())
+		{
+			if (Desc.Name == Names::OwnerActor)
+			{
+				Handles.OwnerActor = Desc.Handle;
+			}
+			else if (Desc.Name == Names::ControllerActor)
+			{
+				Handles.ControllerActor = Desc.Handle;
+			}
+			else if (Desc.Name == Names::PawnActor)
+			{
+				Handles.PawnActor = Desc.Handle;
+			}
+		}
+		FWriteScopeLock WriteLock(ContextCacheLock);
+		return ContextDataHandlesCache.Add(StateTree, Handles);
+	}
+
+	bool DoActiveStatesNeedTick(UStateTree const& StateTree, FStateTreeActiveStates const& ActiveStates)
+	{
+		auto NeedsTick = [&ActiveStates](FCTRLStateTreeTraits const& Traits)
+		{
+			if (Traits.AlwaysNeedsTick()) { return true; }
+			if (Traits.IsLean()) { return false; }
+			for (int32 Index = 0; Index < ActiveStates.Num(); ++Index)
+			{
+				int32 const StateIndex = ActiveStates[Index].Index;
+				if (!Traits.StateNeedsTick.IsValidIndex(StateIndex) || Traits.StateNeedsTick[StateIndex]) { return true; }
+			}
+			return false;
+		};
+		auto const* Schema = Cast<UCTRLPawnStateTreeSchema>(StateTree.GetSchema());
+		if (FCTRLStateTreeTraits const* Traits = Schema ? Schema->GetCompiledTraits() : nullptr)
+		{
+			return NeedsTick(*Traits);
+		}
+		{
+			FReadScopeLock ReadLock(ContextCacheLock);
+			if (FCTRLStateTreeTraits const* Traits = TraitsCache.Find(&StateTree))
+			{
+				return NeedsTick(*Traits);
+			}
+		}
+
+		FCTRLStateTreeTraits Traits;
+		UCTRLPawnStateTreeSchema::ComputeTraits(StateTree, Traits);
+		bool const bNeedsTick = NeedsTick(Traits);
+		FWriteScopeLock WriteLock(ContextCacheLock);
+		TraitsCache.Add(&StateTree, MoveTemp(Traits));
+		return bNeedsTick;
+	}
+
+	bool SetContextData(FStateTreeExecutionContext& StateTreeContext, FStateTreeExternalDataHandle const& Handle, UObject* Object)
+	{
+		if (!Handle.IsValid()) { return false; }
+		StateTreeContext.SetContextData(Handle, FStateTreeDataView(Object));
+		return true;
+	}
+}
+
 TSubclassOf<UStateTreeSchema> UCTRLPawnStateTreeComponent::GetSchema() const
 {
 	return UCTRLPawnStateTreeSchema::StaticClass();
@@ -103,15 +255,131 @@ bool UCTRLPawnStateTreeComponent::ValidateSchema(FStateTreeExecutionContext cons
 	return true;
 }
 
+bool UCTRLPawnStateTreeComponent::ValidateSchemaCached(FStateTreeExecutionContext const& StateTreeContext) const
+{
+	using namespace CTRL::PawnStateTree::Private;
+	FSchemaValidationKey const Key{
+		StateTreeContext.GetStateTree(),
+		IsValid(OwnerActor) ? OwnerActor->GetClass() : nullptr,
+		IsValid(ControllerActor) ? ControllerActor->GetClass() : nullptr,
+		IsValid(PawnActor) ? PawnActor->GetClass() : nullptr,
+		bRequiresController,
+		bRequiresPawn
+	};
+	{
+		FReadScopeLock ReadLock(ContextCacheLock);
+		if (bool const* bCachedIsValid = SchemaValidationCache.Find(Key))
+		{
+			return *bCachedIsValid;
+		}
+	}
+	// ValidateSchema logs, PrepareParallelTick validates on the game thread before the parallel tick
+	if (CTRL::StateTree::IsInParallelTick()) { return false; }
+	// only logs the first time a combination fails
+	bool const bIsValid = ValidateSchema(StateTreeContext);
+	FWriteScopeLock WriteLock(ContextCacheLock);
+	return SchemaValidationCache.Add(Key, bIsValid);
+}
+
+void UCTRLPawnStateTreeComponent::InvalidateContextCache(UStateTree const* StateTree)
+{
+	using namespace CTRL::PawnStateTree::Private;
+	FWriteScopeLock WriteLock(ContextCacheLock);
+	if (!StateTree)
+	{
+		ContextDataHandlesCache.Reset();
+		SchemaValidationCache.Reset();
+		TraitsCache.Reset();
+		return;
+	}
+	ContextDataHandlesCache.Remove(StateTree);
+	TraitsCache.Remove(StateTree);
+	for (auto It = SchemaValidationCache.CreateIterator(); It; ++It)
+	{
+		if (It.Key().StateTree == TObjectKey<UStateTree>(StateTree))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
 void UCTRLPawnStateTreeComponent::OnPossessedPawnChanged(APawn* OldPawn, APawn* NewPawn)
 {
 	PawnActor = NewPawn;
+	bContextActorsDirty = true;
+	UWorld* World = GetWorld();
+	if (!bCoalescePossessionChanges || !World)
+	{
+		ApplyPossessedPawnChange(OldPawn, NewPawn);
+		return;
+	}
+
+	if (NumPendingPossessionChanges++ == 0)
+	{
+		PendingPossessionOldPawn = OldPawn;
+	}
+	FTimerManager& TimerManager = World->GetTimerManager();
+	if (TimerManager.IsTimerActive(PendingPossessedPawnChangeHandle)) { return; }
+	PendingPossessedPawnChangeHandle = TimerManager.SetTimerForNextTick(this, &ThisClass::ApplyPendingPossessedPawnChange);
+}
+
+void UCTRLPawnStateTreeComponent::ApplyPendingPossessedPawnChange()
+{
+	PendingPossessedPawnChangeHandle.Invalidate();
+	APawn* OldPawn = PendingPossessionOldPawn.Get();
+	int32 const NumChanges = NumPendingPossessionChanges;
+	PendingPossessionOldPawn.Reset();
+	NumPendingPossessionChanges = 0;
+	if (NumChanges == 0) { return; }
+
+	// back to the pawn we started with, e.g. unpossess + possess of the same pawn
+	bool const bPawnUnchanged = OldPawn == PawnActor;
+	int32 const NumAvoided = bPawnUnchanged ? NumChanges : NumChanges - 1;
+	AvoidedRestartCount += NumAvoided;
+	INC_DWORD_STAT_BY(STAT_CTRLStateTree_AvoidedRestarts, NumAvoided);
+	if (bPawnUnchanged) { return; }
+
+	ApplyPossessedPawnChange(OldPawn, PawnActor);
+}
+
+void UCTRLPawnStateTreeComponent::ApplyPossessedPawnChange(APawn* OldPawn, APawn* NewPawn)
+{
+	CTRLST_SCOPED_TIMING(PossessionChange, STAT_CTRLStateTree_PossessionChange);
+	if (bRebindPawnOnPossessedPawnChanged && IsRunning())
+	{
+		NotifyPawnChanged(OldPawn, NewPawn);
+		return;
+	}
 	if (bRestartLogicOnPossessedPawnChanged)
 	{
 		RestartLogic();
 	}
 }
 
+void UCTRLPawnStateTreeComponent::NotifyPawnChanged(APawn* OldPawn, APawn* NewPawn)
+{
+	// the PawnActor view is written on every SetContextRequirements, so the next tick already sees the new pawn
+	FCTRLStateTreeContextChangedPayload const Payload{OldPawn, NewPawn};
+	SendStateTreeEvent(CTRL::PawnStateTree::Tags::Event_ContextChanged, FConstStructView::Make(Payload));
+}
+
+void UCTRLPawnStateTreeComponent::SendStateTreeEvent(FStateTreeEvent const& Event)
+{
+	Super::SendStateTreeEvent(Event);
+	WakeUp();
+}
+
+void UCTRLPawnStateTreeComponent::SendStateTreeEvent(FGameplayTag const Tag, FConstStructView const Payload, FName const Origin)
+{
+	Super::SendStateTreeEvent(Tag, Payload, Origin);
+	WakeUp();
+}
+
+void UCTRLPawnStateTreeComponent::SendStateTreeEventAndWakeUp(FStateTreeEvent const& Event)
+{
+	SendStateTreeEvent(Event);
+}
+
 void UCTRLPawnStateTreeComponent::SetController_Implementation(AController* InControllerActor)
 {
 	if (bAutoSetupPawnControllerFromOwner)
@@ -119,6 +387,7 @@ void UCTRLPawnStateTreeComponent::SetController_Implementation(AController* InCo
 		CTRLST_LOG(Warning, TEXT("SetController_Implementation called with bAutoSetupPawnControllerFromOwner set to true. This should not happen."));
 	}
 	ControllerActor = InControllerActor;
+	bContextActorsDirty = true;
 	if (!ControllerActor)
 	{
 		PawnActor = nullptr;
@@ -163,15 +432,551 @@ void UCTRLPawnStateTreeComponent::AssignContextActors()
 
 void UCTRLPawnStateTreeComponent::StartLogic()
 {
+	if (!SoftStateTree.IsNull())
+	{
+		// set first, the load may complete (and start) from within ResolveSoftStateTree
+		bStartPendingLoad = true;
+		if (!ResolveSoftStateTree()) { return; }
+		bStartPendingLoad = false;
+	}
+	if (bUseStartupScheduler && !bHasStartedLogic && !bStartingFromScheduler && !bIsRunning)
+	{
+		if (auto const StartupSubsystem = UCTRLStateTreeStartupSubsystem::Get(this))
+		{
+			StartupSubsystem->Enqueue(this);
+			return;
+		}
+	}
+	CTRLST_SCOPED_TIMING(StartLogic, STAT_CTRLStateTree_StartLogic);
+	bHasStartedLogic = true;
+	WakeUp();
+
+	if (IsUsingBatchedTick())
+	{
+		// moves to the right group if the StateTree asset changed
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			TickSubsystem->Register(this);
+		}
+	}
+
+	// swapping storage would drop events queued before the start
+	UWorld const* World = GetWorld();
+	if (!bIsRunning && !bInstanceDataFromPool && World && StateTreeRef.IsValid() && !HasPendingEvents() && UCTRLStateTreeInstanceDataPoolSubsystem::IsPoolingEnabled())
+	{
+		if (auto const PoolSubsystem = World->GetSubsystem<UCTRLStateTreeInstanceDataPoolSubsystem>())
+		{
+			PoolSubsystem->Acquire(StateTreeRef.GetStateTree(), InstanceData);
+			PooledStateTree = StateTreeRef.GetStateTree();
+			bInstanceDataFromPool = true;
+		}
+	}
 	Super::StartLogic();
 }
 
+void UCTRLPawnStateTreeComponent::StartLogicImmediately()
+{
+	if (auto const StartupSubsystem = UCTRLStateTreeStartupSubsystem::Get(this))
+	{
+		StartupSubsystem->Dequeue(this);
+	}
+	StartLogicFromScheduler();
+}
+
+bool UCTRLPawnStateTreeComponent::IsStartPending() const
+{
+	if (bStartPendingLoad) { return true; }
+	auto const StartupSubsystem = bUseStartupScheduler ? UCTRLStateTreeStartupSubsystem::Get(this) : nullptr;
+	return StartupSubsystem && StartupSubsystem->IsQueued(this);
+}
+
+bool UCTRLPawnStateTreeComponent::ResolveSoftStateTree()
+{
+	UStateTree* StateTree = SoftStateTree.Get();
+	if (!StateTree)
+	{
+		auto const LoadingSubsystem = UCTRLStateTreeLoadingSubsystem::Get(this);
+		if (LoadingSubsystem)
+		{
+			LoadingSubsystem->RequestLoad(SoftStateTree, FStreamableDelegate::CreateUObject(this, &ThisClass::OnSoftStateTreeLoaded));
+			return false;
+		}
+		// e.g. editor preview worlds
+		StateTree = SoftStateTree.LoadSynchronous();
+		if (!StateTree) { return false; }
+	}
+	if (StateTreeRef.GetStateTree() != StateTree)
+	{
+		StateTreeRef.SetStateTree(StateTree);
+	}
+	return true;
+}
+
+void UCTRLPawnStateTreeComponent::OnSoftStateTreeLoaded()
+{
+	if (!bStartPendingLoad) { return; }
+	if (!SoftStateTree.Get())
+	{
+		bStartPendingLoad = false;
+		return;
+	}
+	StartLogic();
+}
+
+void UCTRLPawnStateTreeComponent::StartLogicFromScheduler()
+{
+	TGuardValue<bool> StartingGuard(bStartingFromScheduler, true);
+	StartLogic();
+}
+
+void UCTRLPawnStateTreeComponent::StopLogic(FString const& Reason)
+{
+	CTRLST_SCOPED_TIMING(StopLogic, STAT_CTRLStateTree_StopLogic);
+	bStartPendingLoad = false;
+	if (bUseStartupScheduler)
+	{
+		// cancels a queued start
+		if (auto const StartupSubsystem = UCTRLStateTreeStartupSubsystem::Get(this))
+		{
+			StartupSubsystem->Dequeue(this);
+		}
+	}
+	WakeUp();
+	Super::StopLogic(Reason);
+	if (bIsRunning) { return; }
+	ReleasePooledInstanceData();
+}
+
+void UCTRLPawnStateTreeComponent::ReleasePooledInstanceData()
+{
+	if (!bInstanceDataFromPool) { return; }
+	bInstanceDataFromPool = false;
+	UWorld const* World = GetWorld();
+	if (auto const PoolSubsystem = World ? World->GetSubsystem<UCTRLStateTreeInstanceDataPoolSubsystem>() : nullptr)
+	{
+		PoolSubsystem->Release(PooledStateTree.Get(), InstanceData);
+	}
+	PooledStateTree.Reset();
+}
+
 void UCTRLPawnStateTreeComponent::BeginPlay()
 {
+	if (bUseBatchedTick)
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			TickSubsystem->Register(this);
+		}
+	}
+	if (bUseSignificanceLOD)
+	{
+		if (auto const LODSubsystem = UCTRLStateTreeLODSubsystem::Get(this))
+		{
+			PreLODTickInterval = GetStateTreeTickInterval();
+			LODSubsystem->Register(this);
+		}
+	}
+	if (!SoftStateTree.IsNull() && bPreloadSoftStateTree)
+	{
+		ResolveSoftStateTree();
+	}
 	Super::BeginPlay();
 	AssignContextActors();
 }
 
+void UCTRLPawnStateTreeComponent::EndPlay(EEndPlayReason::Type const EndPlayReason)
+{
+	if (UWorld const* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(PendingPossessedPawnChangeHandle);
+	}
+	PendingPossessionOldPawn.Reset();
+	NumPendingPossessionChanges = 0;
+	bStartPendingLoad = false;
+	WakeUp();
+	if (bUseStartupScheduler)
+	{
+		if (auto const StartupSubsystem = UCTRLStateTreeStartupSubsystem::Get(this))
+		{
+			StartupSubsystem->Dequeue(this);
+		}
+	}
+	if (bUseSignificanceLOD)
+	{
+		if (auto const LODSubsystem = UCTRLStateTreeLODSubsystem::Get(this))
+		{
+			LODSubsystem->Unregister(this);
+		}
+	}
+	if (IsUsingBatchedTick())
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			TickSubsystem->Unregister(this);
+		}
+	}
+	Super::EndPlay(EndPlayReason);
+	// the base EndPlay stops the tree without going through StopLogic
+	if (!bIsRunning)
+	{
+		ReleasePooledInstanceData();
+	}
+}
+
+void UCTRLPawnStateTreeComponent::UninitializeComponent()
+{
+	Super::UninitializeComponent();
+	// the tree is stopped (or torn down) by now, so the storage can't be in use anymore
+	ReleasePooledInstanceData();
+}
+
+void UCTRLPawnStateTreeComponent::SetStateTreeTickEnabled(bool const bEnabled)
+{
+	if (IsUsingBatchedTick())
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			TickSubsystem->SetTickEnabled(this, bEnabled);
+			return;
+		}
+	}
+	SetComponentTickEnabled(bEnabled);
+}
+
+bool UCTRLPawnStateTreeComponent::IsStateTreeTickEnabled() const
+{
+	if (IsUsingBatchedTick())
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			return TickSubsystem->IsTickEnabled(this);
+		}
+	}
+	return IsComponentTickEnabled();
+}
+
+void UCTRLPawnStateTreeComponent::SetStateTreeTickInterval(float const TickInterval)
+{
+	if (IsUsingBatchedTick())
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			TickSubsystem->SetTickInterval(this, TickInterval);
+			return;
+		}
+	}
+	SetComponentTickInterval(TickInterval);
+}
+
+float UCTRLPawnStateTreeComponent::GetStateTreeTickInterval() const
+{
+	if (IsUsingBatchedTick())
+	{
+		if (auto const TickSubsystem = UCTRLPawnStateTreeTickSubsystem::Get(this))
+		{
+			return TickSubsystem->GetTickInterval(this);
+		}
+	}
+	return GetComponentTickInterval();
+}
+
+void UCTRLPawnStateTreeComponent::OnUnregisteredFromBatchedTick(float const TickInterval, bool const bTickEnabled)
+{
+	// also reached from the subsystem's Deinitialize, IsUsingBatchedTick must not outlive it
+	BatchedTickGroupIndex = INDEX_NONE;
+	BatchedTickEntryIndex = INDEX_NONE;
+	SetComponentTickInterval(TickInterval);
+	SetComponentTickEnabled(bTickEnabled);
+}
+
+bool UCTRLPawnStateTreeComponent::NeedsContextActorsUpdate() const
+{
+	// a missing controller or pawn is the normal state of an unpossessed pawn, possession & controller changes set the flag
+	return bContextActorsDirty;
+}
+
+void UCTRLPawnStateTreeComponent::UpdateContextActors()
+{
+	AssignContextActors();
+	if (!OwnerActor)
+	{
+		OwnerActor = GetOwner();
+		AssignContextActors();
+	}
+	bContextActorsDirty = false;
+	// may have resolved to the previous pawn or controller
+	ExternalDataCache.Reset();
+}
+
+bool UCTRLPawnStateTreeComponent::CollectExternalData(
+	FStateTreeExecutionContext const& Context,
+	UStateTree const* StateTree,
+	TArrayView<FStateTreeExternalDataDesc const> ExternalDataDescs,
+	TArrayView<FStateTreeDataView> OutDataViews
+) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_CollectExternalData);
+	check(ExternalDataDescs.Num() == OutDataViews.Num());
+
+	FCTRLPawnStateTreeExternalData const* Cached = FindOrResolveExternalData(StateTree, ExternalDataDescs);
+	if (!Cached) { return false; }
+
+	bool bFoundAllRequired = true;
+	for (int32 Index = 0; Index < ExternalDataDescs.Num(); ++Index)
+	{
+		UObject* Object = Cached->Objects[Index].Get();
+		OutDataViews[Index] = FStateTreeDataView(Object);
+		bFoundAllRequired &= Object != nullptr || ExternalDataDescs[Index].Requirement != EStateTreeExternalDataRequirement::Required;
+	}
+	return bFoundAllRequired;
+}
+
+FCTRLPawnStateTreeExternalData* UCTRLPawnStateTreeComponent::FindOrResolveExternalData(
+	UStateTree const* StateTree,
+	TConstArrayView<FStateTreeExternalDataDesc> const ExternalDataDescs
+) const
+{
+	UWorld const* World = GetWorld();
+	if (ExternalDataWorld.Get() != World)
+	{
+		ExternalDataCache.Reset();
+		ExternalDataWorld = World;
+	}
+
+	FCTRLPawnStateTreeExternalData* Cached = ExternalDataCache.FindByPredicate(
+		[StateTree](FCTRLPawnStateTreeExternalData const& Entry) { return Entry.StateTree == StateTree; }
+	);
+	bool bNeedsResolve = !Cached || Cached->Objects.Num() != ExternalDataDescs.Num();
+	for (int32 Index = 0; Index < ExternalDataDescs.Num() && !bNeedsResolve; ++Index)
+	{
+		// a required object went away
+		bNeedsResolve = ExternalDataDescs[Index].Requirement == EStateTreeExternalDataRequirement::Required && !Cached->Objects[Index].IsValid();
+	}
+	if (!bNeedsResolve) { return Cached; }
+	// looks up subsystems & components, PrepareParallelTick resolves on the game thread before the parallel tick
+	if (CTRL::StateTree::IsInParallelTick()) { return nullptr; }
+
+	if (!Cached)
+	{
+		Cached = &ExternalDataCache.AddDefaulted_GetRef();
+		Cached->StateTree = StateTree;
+	}
+	Cached->Objects.Reset(ExternalDataDescs.Num());
+	for (FStateTreeExternalDataDesc const& Desc : ExternalDataDescs)
+	{
+		Cached->Objects.Add(ResolveExternalData(Desc));
+	}
+	INC_DWORD_STAT(STAT_CTRLStateTree_ExternalDataResolves);
+	return Cached;
+}
+
+UObject* UCTRLPawnStateTreeComponent::ResolveExternalData(FStateTreeExternalDataDesc const& Desc) const
+{
+	UClass* Class = const_cast<UClass*>(Cast<UClass>(Desc.Struct.Get()));
+	if (!Class) { return nullptr; }
+
+	if (Class->IsChildOf(UWorldSubsystem::StaticClass()))
+	{
+		UWorld const* World = GetWorld();
+		return World ? World->GetSubsystemBase(Class) : nullptr;
+	}
+
+	AActor* const Actors[] = {Cast<AActor>(OwnerActor), PawnActor, ControllerActor};
+	if (Class->IsChildOf(AActor::StaticClass()))
+	{
+		for (AActor* Actor : Actors)
+		{
+			if (IsValid(Actor) && Actor->IsA(Class)) { return Actor; }
+		}
+	}
+	else if (Class->IsChildOf(UActorComponent::StaticClass()))
+	{
+		for (AActor* Actor : Actors)
+		{
+			if (!IsValid(Actor)) { continue; }
+			if (UActorComponent* Component = Actor->FindComponentByClass(Class)) { return Component; }
+		}
+	}
+	return nullptr;
+}
+
+bool UCTRLPawnStateTreeComponent::PrepareParallelTick(TConstArrayView<TObjectPtr<UStateTree const>> const LinkedStateTrees)
+{
+	if (NeedsContextActorsUpdate())
+	{
+		UpdateContextActors();
+	}
+	if (!bIsRunning || bIsPaused) { return false; }
+	UStateTree const* StateTree = StateTreeRef.GetStateTree();
+	if (!StateTree) { return false; }
+
+	// the workers only read the cached results
+	FStateTreeExecutionContext Context(*GetOwner(), *StateTree, InstanceData);
+	if (!ValidateSchemaCached(Context)) { return false; }
+	FindOrResolveExternalData(StateTree, StateTree->GetExternalDataDescs());
+	for (UStateTree const* LinkedStateTree : LinkedStateTrees)
+	{
+		if (!LinkedStateTree) { continue; }
+		FindOrResolveExternalData(LinkedStateTree, LinkedStateTree->GetExternalDataDescs());
+	}
+	return true;
+}
+
+void UCTRLPawnStateTreeComponent::TickStateTreeParallel(float const DeltaTime)
+{
+	if (!bIsRunning || bIsPaused) { return; }
+	UStateTree const* StateTree = StateTreeRef.GetStateTree();
+	if (!StateTree) { return; }
+	CTRLST_SCOPED_TIMING(Tick, STAT_CTRLStateTree_Tick);
+
+	FStateTreeExecutionContext Context(*GetOwner(), *StateTree, InstanceData);
+	if (!SetContextRequirements(Context, /*bLogErrors*/ false)) { return; }
+
+	EStateTreeRunStatus const PreviousRunStatus = Context.GetStateTreeRunStatus();
+	EStateTreeRunStatus const CurrentRunStatus = Context.Tick(DeltaTime);
+	if (CurrentRunStatus != PreviousRunStatus)
+	{
+		CTRL::StateTree::RunOnGameThread(
+			[WeakThis = TWeakObjectPtr<ThisClass>(this), CurrentRunStatus]()
+			{
+				if (ThisClass* This = WeakThis.Get())
+				{
+					This->OnStateTreeRunStatusChanged.Broadcast(CurrentRunStatus);
+				}
+			}
+		);
+	}
+}
+
+bool UCTRLPawnStateTreeComponent::HasPendingEvents() const
+{
+	return InstanceData.GetEventQueue().HasEvents();
+}
+
+void UCTRLPawnStateTreeComponent::TickComponent(float const DeltaTime, ELevelTick const TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	{
+		CTRLST_SCOPED_TIMING(Tick, STAT_CTRLStateTree_Tick);
+		Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	}
+	UpdateSleep();
+}
+
+bool UCTRLPawnStateTreeComponent::CanSleep() const
+{
+	if (!bIsRunning || bIsPaused || HasPendingEvents()) { return false; }
+	FStateTreeExecutionState const* ExecState = InstanceData.GetExecutionState();
+	if (!ExecState || ExecState->TreeRunStatus != EStateTreeRunStatus::Running) { return false; }
+	// delays are counted down by the tick
+	if (!ExecState->DelayedTransitions.IsEmpty()) { return false; }
+
+	using namespace CTRL::PawnStateTree::Private;
+	for (FStateTreeExecutionFrame const& Frame : ExecState->ActiveFrames)
+	{
+		if (!Frame.StateTree || DoActiveStatesNeedTick(*Frame.StateTree, Frame.ActiveStates)) { return false; }
+	}
+	return true;
+}
+
+void UCTRLPawnStateTreeComponent::UpdateSleep()
+{
+	if (!bUseSleepMode || bIsSleeping || !CanSleep()) { return; }
+	auto const SleepSubsystem = UCTRLStateTreeSleepSubsystem::Get(this);
+	if (!SleepSubsystem) { return; }
+	if (ScheduledWakeTime > 0. && GetWorld()->GetTimeSeconds() >= ScheduledWakeTime)
+	{
+		// already ticked since
+		ScheduledWakeTime = 0.;
+	}
+	bIsSleeping = true;
+	SetStateTreeTickEnabled(false);
+	SleepSubsystem->Add(this, ScheduledWakeTime);
+}
+
+void UCTRLPawnStateTreeComponent::WakeUp()
+{
+	UWorld const* World = GetWorld();
+	if (ScheduledWakeTime > 0. && World && World->GetTimeSeconds() >= ScheduledWakeTime)
+	{
+		ScheduledWakeTime = 0.;
+	}
+	if (!bIsSleeping) { return; }
+	bIsSleeping = false;
+	if (auto const SleepSubsystem = UCTRLStateTreeSleepSubsystem::Get(this))
+	{
+		SleepSubsystem->Remove(this);
+	}
+	// a dormant LOD band turns the tick back off on its next update if no event is pending
+	SetStateTreeTickEnabled(true);
+}
+
+void UCTRLPawnStateTreeComponent::WakeUpAfter(float const Seconds)
+{
+	UWorld const* World = GetWorld();
+	if (!World) { return; }
+	double const WakeTime = World->GetTimeSeconds() + FMath::Max(0.f, Seconds);
+	if (ScheduledWakeTime > 0. && ScheduledWakeTime <= WakeTime) { return; }
+	ScheduledWakeTime = WakeTime;
+	if (!bIsSleeping) { return; }
+	if (auto const SleepSubsystem = UCTRLStateTreeSleepSubsystem::Get(this))
+	{
+		SleepSubsystem->SetWakeTime(this, ScheduledWakeTime);
+	}
+}
+
+void UCTRLPawnStateTreeComponent::WakeUpStateTrees(UObject const* Owner)
+{
+	AActor const* Actor = Cast<AActor>(Owner);
+	if (!Actor && Owner)
+	{
+		Actor = Owner->GetTypedOuter<AActor>();
+	}
+	if (!Actor) { return; }
+	TInlineComponentArray<UCTRLPawnStateTreeComponent*> Components(Actor);
+	for (UCTRLPawnStateTreeComponent* Component : Components)
+	{
+		Component->WakeUp();
+	}
+}
+
+void UCTRLPawnStateTreeComponent::ApplyLODBand(int32 const BandIndex, FCTRLStateTreeLODBand const& Band)
+{
+	// sleeping trees get their tick back from WakeUp
+	if (!bIsSleeping)
+	{
+		if (Band.bDormant)
+		{
+			// dormant trees only tick for the frame after an event was queued
+			bool const bShouldTick = HasPendingEvents();
+			if (IsStateTreeTickEnabled() != bShouldTick)
+			{
+				SetStateTreeTickEnabled(bShouldTick);
+			}
+		}
+		else if (bLODDormant)
+		{
+			SetStateTreeTickEnabled(true);
+		}
+	}
+
+	if (LODBandIndex == BandIndex) { return; }
+	LODBandIndex = BandIndex;
+	bLODDormant = Band.bDormant;
+	SetStateTreeTickInterval(Band.bDormant ? 0.f : Band.TickInterval);
+}
+
+void UCTRLPawnStateTreeComponent::ClearLODBand()
+{
+	if (LODBandIndex == INDEX_NONE) { return; }
+	LODBandIndex = INDEX_NONE;
+	bLODDormant = false;
+	SetStateTreeTickInterval(PreLODTickInterval);
+	if (!bIsSleeping)
+	{
+		SetStateTreeTickEnabled(true);
+	}
+}
+
 bool UCTRLPawnStateTreeComponent::SetContextRequirements(FStateTreeExecutionContext& StateTreeContext, bool bLogErrors)
 {
 	if (!IsValid(this))
@@ -187,41 +992,38 @@ bool UCTRLPawnStateTreeComponent::SetContextRequirements(FStateTreeExecutionCont
 		return false;
 	}
 
-	AssignContextActors();
-	if (!OwnerActor)
+	// only re-resolve the context actors when they changed (or went away) since the last call
+	if (NeedsContextActorsUpdate())
 	{
-		OwnerActor = StateTreeContext.GetOwner();
-		AssignContextActors();
+		// assigning binds delegates & calls blueprint events, PrepareParallelTick does it for the parallel tick
+		if (CTRL::StateTree::IsInParallelTick()) { return false; }
+		UpdateContextActors();
 	}
 
-	if (!ValidateSchema(StateTreeContext)) { return false; }
+	if (!ValidateSchemaCached(StateTreeContext)) { return false; }
 
-	if (!StateTreeContext.SetContextDataByName(CTRL::PawnStateTree::Names::OwnerActor, FStateTreeDataView(OwnerActor)))
+	using namespace CTRL::PawnStateTree::Private;
+	FContextDataHandles const Handles = GetContextDataHandles(StateTreeContext.GetStateTree());
+
+	if (!SetContextData(StateTreeContext, Handles.OwnerActor, OwnerActor))
 	{
 		CTRLST_LOG(Warning, TEXT("Failed to set context requirements. OwnerActor is not valid."));
 		return false;
 	}
 
-	if (!StateTreeContext.SetContextDataByName(CTRL::PawnStateTree::Names::ControllerActor, FStateTreeDataView(ControllerActor)))
+	if (!SetContextData(StateTreeContext, Handles.ControllerActor, ControllerActor))
 	{
 		if (bRequiresController)
 		{
 			CTRLST_LOG(Warning, TEXT("Failed to set context requirements. ControllerActor is not valid."));
-			// return false;
-			// auto OuterController = GetTypedOuter<APlayerController>();
-			// if (OuterController && !OuterController->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
-			// {
-			// 	ControllerActor = OuterController;
-			// }
 		}
 	}
 
-	if (!StateTreeContext.SetContextDataByName(CTRL::PawnStateTree::Names::PawnActor, FStateTreeDataView(PawnActor)))
+	if (!SetContextData(StateTreeContext, Handles.PawnActor, PawnActor))
 	{
 		if (bRequiresPawn)
 		{
 			CTRLST_LOG(Warning, TEXT("Failed to set context requirements. PawnActor is not valid."));
-			// PawnActor = ControllerActor ? ControllerActor->GetPawn() : nullptr;
 			return false;
 		}
 	}
@@ -233,44 +1035,15 @@ bool UCTRLPawnStateTreeComponent::SetContextRequirements(FStateTreeExecutionCont
 	// CTRLST_LOG(Warning, TEXT("SetContextRequirements InstanceData CardStacks UID: %d"), StInstanceData->GetObject(2)->GetUniqueID());
 
 	checkf(OwnerActor != nullptr, TEXT("Should never reach this point with an invalid OwnerActor since it is required to get a valid StateTreeContext."));
-	UWorld const* World = OwnerActor->GetWorld();
-
-	// StateTreeContext.SetCollectExternalDataCallback(
-	// 	FOnCollectStateTreeExternalData::CreateWeakLambda(
-	// 		this,
-	// 		[World, this](
-	// 		FStateTreeExecutionContext const& Context,
-	// 		UStateTree const* StateTree,
-	// 		TArrayView<FStateTreeExternalDataDesc const> ExternalDescs,
-	// 		TArrayView<FStateTreeDataView> OutDataViews
-	// 	)
-	// 		{
-	// 			check(ExternalDescs.Num() == OutDataViews.Num());
-	// 			for (int32 Index = 0; Index < ExternalDescs.Num(); Index++)
-	// 			{
-	// 				FStateTreeExternalDataDesc const& Desc = ExternalDescs[Index];
-	// 				if (Desc.Struct != nullptr)
-	// 				{
-	// 					if (World != nullptr && Desc.Struct->IsChildOf(UWorldSubsystem::StaticClass()))
-	// 					{
-	// 						UWorldSubsystem* Subsystem = World->GetSubsystemBase(Cast<UClass>(const_cast<UStruct*>(ToRawPtr(Desc.Struct))));
-	// 						OutDataViews[Index] = FStateTreeDataView(Subsystem);
-	// 					}
-	// 					else if (Desc.Struct->IsChildOf(AController::StaticClass()))
-	// 					{
-	// 						OutDataViews[Index] = FStateTreeDataView(ControllerActor);
-	// 					}
-	// 					else if (Desc.Struct->IsChildOf(APawn::StaticClass()))
-	// 					{
-	// 						OutDataViews[Index] = FStateTreeDataView(PawnActor);
-	// 					}
-	// 				}
-	// 			}
-	//
-	// 			return true;
-	// 		}
-	// 	)
-	// );
+	if (!CTRL::StateTree::IsInParallelTick())
+	{
+		StateTreeContext.SetCollectExternalDataCallback(FOnCollectStateTreeExternalData::CreateUObject(this, &ThisClass::CollectExternalData));
+	}
+	else
+	{
+		// the parallel tick's context doesn't outlive the call, no need for a UObject binding
+		StateTreeContext.SetCollectExternalDataCallback(FOnCollectStateTreeExternalData::CreateRaw(this, &ThisClass::CollectExternalData));
+	}
 
 	return true;
 	// auto const Valid = StateTreeContext.AreContextDataViewsValid();
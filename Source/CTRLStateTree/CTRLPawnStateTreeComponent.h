@@ -6,10 +6,43 @@
 #include "CoreMinimal.h"
 #include "StateTreeSchema.h"
 
+#include "NativeGameplayTags.h"
+
 #include "Components/StateTreeComponent.h"
 
+#include "Engine/TimerHandle.h"
+
 #include "CTRLPawnStateTreeComponent.generated.h"
 
+struct FCTRLStateTreeLODBand;
+class UCTRLPawnStateTreeTickSubsystem;
+class UCTRLStateTreeStartupSubsystem;
+
+namespace CTRL::PawnStateTree::Tags
+{
+	// Sent when a context actor was swapped in place, payload is FCTRLStateTreeContextChangedPayload
+	CTRLSTATETREE_API UE_DECLARE_GAMEPLAY_TAG_EXTERN(Event_ContextChanged);
+}
+
+USTRUCT(BlueprintType)
+struct CTRLSTATETREE_API FCTRLStateTreeContextChangedPayload
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree")
+	TObjectPtr<APawn> OldPawn = nullptr;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree")
+	TObjectPtr<APawn> NewPawn = nullptr;
+};
+
+// External data objects resolved for one StateTree asset, in ExternalDataDescs order
+struct FCTRLPawnStateTreeExternalData
+{
+	TWeakObjectPtr<UStateTree const> StateTree;
+	TArray<TWeakObjectPtr<UObject>> Objects;
+};
+
 UCLASS(DisplayName="Pawn StateTree Component [CTRL]", meta=(BlueprintSpawnableComponent))
 class CTRLSTATETREE_API UCTRLPawnStateTreeComponent : public UStateTreeComponent
 {
@@ -39,7 +72,57 @@ public:
 	virtual void SetController_Implementation(AController* InControllerActor);
 	void AssignContextActors();
 	virtual void StartLogic() override;
+	virtual void StopLogic(FString const& Reason) override;
+
+	// Starts now, skipping (or leaving) the startup queue. For gameplay critical actors using bUseStartupScheduler
+	UFUNCTION(BlueprintCallable, Category="State Tree")
+	void StartLogicImmediately();
+	// True while waiting in the startup queue or for SoftStateTree to load
+	UFUNCTION(BlueprintPure, Category="State Tree")
+	bool IsStartPending() const;
 	virtual void BeginPlay() override;
+	virtual void EndPlay(EEndPlayReason::Type EndPlayReason) override;
+	virtual void UninitializeComponent() override;
+
+	// Lets the running tree pick up a new pawn without restarting: sends the ContextChanged event so tasks can re-resolve via OnContextChanged
+	void NotifyPawnChanged(APawn* OldPawn, APawn* NewPawn);
+
+	// True if StateTree events are queued and waiting for the next tick
+	bool HasPendingEvents() const;
+	// Storage of the running instance, possibly taken from UCTRLStateTreeInstanceDataPoolSubsystem
+	FStateTreeInstanceData const& GetStateTreeInstanceData() const { return InstanceData; }
+
+	// Hide the base senders so C++ callers of this component also wake a sleeping tree. Queued events aren't polled,
+	// senders going through a UStateTreeComponent pointer or Blueprint need SendStateTreeEventAndWakeUp or WakeUp
+	void SendStateTreeEvent(FStateTreeEvent const& Event);
+	void SendStateTreeEvent(FGameplayTag Tag, FConstStructView Payload = FConstStructView(), FName Origin = FName());
+	UFUNCTION(BlueprintCallable, Category="State Tree|Sleep")
+	void SendStateTreeEventAndWakeUp(FStateTreeEvent const& Event);
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Re-enables the tick of a sleeping tree. Needed when a task is finished from outside the tree, e.g. FinishTask from a delegate
+	UFUNCTION(BlueprintCallable, Category="State Tree|Sleep")
+	void WakeUp();
+	// Wakes a sleeping tree after Seconds at the latest. The earliest pending request wins
+	UFUNCTION(BlueprintCallable, Category="State Tree|Sleep")
+	void WakeUpAfter(float Seconds);
+	UFUNCTION(BlueprintPure, Category="State Tree|Sleep")
+	bool IsSleeping() const { return bIsSleeping; }
+	// Wakes the pawn state tree components of Owner's actor, for event senders that only know the StateTree owner
+	static void WakeUpStateTrees(UObject const* Owner);
+
+	// Tick control that works whether this component ticks itself or via UCTRLPawnStateTreeTickSubsystem
+	void SetStateTreeTickEnabled(bool bEnabled);
+	bool IsStateTreeTickEnabled() const;
+	void SetStateTreeTickInterval(float TickInterval);
+	float GetStateTreeTickInterval() const;
+	bool IsUsingBatchedTick() const { return BatchedTickEntryIndex != INDEX_NONE; }
+
+	// Called by UCTRLStateTreeLODSubsystem with the band this component currently falls in
+	void ApplyLODBand(int32 BandIndex, FCTRLStateTreeLODBand const& Band);
+	// Restores the tick settings from before LOD was applied
+	void ClearLODBand();
 
 	UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category="State Tree")
 	TObjectPtr<AController> ControllerActor;
@@ -63,5 +146,118 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree")
 	bool bRestartLogicOnPossessedPawnChanged = true;
 
+	// if true, a running tree keeps its active states on possession change and only swaps the PawnActor context data.
+	// Takes precedence over bRestartLogicOnPossessedPawnChanged while running
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree")
+	bool bRebindPawnOnPossessedPawnChanged = false;
+
+	// if true, possession changes are applied on the next tick using the final pawn, so an unpossess + possess
+	// in the same frame restarts (or rebinds) once instead of twice. Off by default to keep the restart in the same frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree")
+	bool bCoalescePossessionChanges = false;
+
+	// Restarts (or rebinds) skipped by bCoalescePossessionChanges
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category="State Tree")
+	int32 AvoidedRestartCount = 0;
+
+	// if true, tick rate is scaled by distance & visibility to player view points. See UCTRLStateTreeSettings::LODBands
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|LOD")
+	bool bUseSignificanceLOD = false;
+
+	// if true, the first StartLogic is queued with UCTRLStateTreeStartupSubsystem and runs within a per-frame budget,
+	// nearest to a player first. Later (re)starts are immediate
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|Startup")
+	bool bUseStartupScheduler = false;
+
+	// if true, the tick is disabled while the active states have no ticking tasks, tick triggered transitions or pending delayed transitions,
+	// and no evaluators or ticking global tasks exist. Woken by StateTree events or WakeUpAfter
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|Sleep")
+	bool bUseSleepMode = false;
+
+	// if set, StateTreeRef is filled from this asset once UCTRLStateTreeLoadingSubsystem loaded and warmed it up; StartLogic waits for the load.
+	// Runs with the asset's default parameters
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|Loading")
+	TSoftObjectPtr<UStateTree> SoftStateTree;
+
+	// if true, SoftStateTree starts loading on BeginPlay instead of on the first StartLogic
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|Loading")
+	bool bPreloadSoftStateTree = true;
+
+	// if true, ticked together with other pawn state trees by UCTRLPawnStateTreeTickSubsystem instead of its own tick function
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="State Tree|Tick")
+	bool bUseBatchedTick = false;
+
+	// Current LOD band, INDEX_NONE if not using LOD
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category="State Tree|LOD")
+	int32 LODBandIndex = INDEX_NONE;
+
 	virtual bool SetContextRequirements(FStateTreeExecutionContext& StateTreeContext, bool bLogErrors) override;
+
+	// Drops cached context data handles, schema validation & fallback traits for StateTree (or all StateTrees if null), e.g. after a recompile.
+	static void InvalidateContextCache(UStateTree const* StateTree = nullptr);
+
+protected:
+	// Schema validation, cached per (StateTree, Owner/Controller/Pawn class) so repeated starts skip the IsA checks.
+	bool ValidateSchemaCached(FStateTreeExecutionContext const& StateTreeContext) const;
+
+	// Resolves external data from the cache, filled once per StateTree asset and dropped when the context actors or world change
+	virtual bool CollectExternalData(FStateTreeExecutionContext const& Context, UStateTree const* StateTree, TArrayView<FStateTreeExternalDataDesc const> ExternalDataDescs, TArrayView<FStateTreeDataView> OutDataViews) const override;
+	// Cached external data of StateTree, resolved if missing or stale. Null if it needs resolving off the game thread
+	FCTRLPawnStateTreeExternalData* FindOrResolveExternalData(UStateTree const* StateTree, TConstArrayView<FStateTreeExternalDataDesc> ExternalDataDescs) const;
+	// World subsystem, or actor/component found on the owner, pawn or controller
+	UObject* ResolveExternalData(FStateTreeExternalDataDesc const& Desc) const;
+	mutable TArray<FCTRLPawnStateTreeExternalData, TInlineAllocator<1>> ExternalDataCache;
+	mutable TWeakObjectPtr<UWorld const> ExternalDataWorld;
+
+	// Set when Controller/Pawn change, so the next SetContextRequirements re-assigns the context actors. Only this flag
+	// triggers it, a missing actor doesn't
+	bool bContextActorsDirty = true;
+	bool NeedsContextActorsUpdate() const;
+	void UpdateContextActors();
+
+	// Restart or rebind for a pawn change, depending on settings
+	void ApplyPossessedPawnChange(APawn* OldPawn, APawn* NewPawn);
+	void ApplyPendingPossessedPawnChange();
+	FTimerHandle PendingPossessedPawnChangeHandle;
+	// Pawn before the first of the coalesced possession changes
+	TWeakObjectPtr<APawn> PendingPossessionOldPawn;
+	int32 NumPendingPossessionChanges = 0;
+
+	// Fills StateTreeRef from SoftStateTree. Returns false and requests the load if it isn't loaded yet
+	bool ResolveSoftStateTree();
+	void OnSoftStateTreeLoaded();
+	bool bStartPendingLoad = false;
+
+	friend UCTRLStateTreeStartupSubsystem;
+	void StartLogicFromScheduler();
+	bool bStartingFromScheduler = false;
+	bool bHasStartedLogic = false;
+
+	// Puts the tree to sleep if nothing active needs a tick. Game thread only
+	void UpdateSleep();
+	bool CanSleep() const;
+	bool bIsSleeping = false;
+	// World time requested by WakeUpAfter, 0 if none
+	double ScheduledWakeTime = 0.;
+
+	friend UCTRLPawnStateTreeTickSubsystem;
+	// Restores the component's own tick function with the batched tick settings
+	void OnUnregisteredFromBatchedTick(float TickInterval, bool bTickEnabled);
+	// Game thread work that must happen before TickStateTreeParallel: resolving dirty context actors, validating the schema
+	// and resolving the external data of StateTree & LinkedStateTrees. False if the tree shouldn't tick
+	bool PrepareParallelTick(TConstArrayView<TObjectPtr<UStateTree const>> LinkedStateTrees);
+	// StateTree only tick used by the parallel batched tick. Skips the actor component tick and defers the run status broadcast to the game thread
+	void TickStateTreeParallel(float DeltaTime);
+	int32 BatchedTickGroupIndex = INDEX_NONE;
+	int32 BatchedTickEntryIndex = INDEX_NONE;
+
+	// Instance data storage was taken from UCTRLStateTreeInstanceDataPoolSubsystem and goes back on StopLogic,
+	// or on EndPlay/UninitializeComponent when the tree was stopped without StopLogic
+	bool bInstanceDataFromPool = false;
+	TWeakObjectPtr<UStateTree const> PooledStateTree;
+	void ReleasePooledInstanceData();
+
+	// Tick interval before LOD took over
+	float PreLODTickInterval = 0.f;
+	bool bLODDormant = false;
 };
@@ -3,7 +3,15 @@
 
 #include "CTRLPawnStateTreeSchema.h"
 
+#include "StateTree.h"
+#include "StateTreeEvaluatorBase.h"
 #include "StateTreeExecutionContext.h"
+#include "StateTreeTaskBase.h"
+
+#include "Algo/AllOf.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
 
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
@@ -45,6 +53,12 @@ TConstArrayView<FStateTreeExternalDataDesc> UCTRLPawnStateTreeSchema::GetContext
 
 bool UCTRLPawnStateTreeSchema::IsStructAllowed(UScriptStruct const* InScriptStruct) const
 {
+#if WITH_EDITOR
+	if (bParallelSafe && !IsNodeThreadSafe(InScriptStruct))
+	{
+		return false;
+	}
+#endif
 	// CTRLST_LOG(Warning, TEXT("IsStructAllowed %s"), *InScriptStruct->GetName());
 	return true;
 	// return InScriptStruct->IsChildOf(FStateTreeConditionCommonBase::StaticStruct())
@@ -75,7 +89,135 @@ void UCTRLPawnStateTreeSchema::PostLoad()
 	ContextDataDescs[2].Struct = OwnerActorClass.Get();
 }
 
+void UCTRLPawnStateTreeSchema::ComputeTraits(UStateTree const& StateTree, FCTRLStateTreeTraits& OutTraits)
+{
+	OutTraits = FCTRLStateTreeTraits();
+	FInstancedStructContainer const& Nodes = StateTree.GetNodes();
+	TConstArrayView<FCompactStateTreeState> const States = StateTree.GetStates();
+	TBitArray<> IsStateTask(false, Nodes.Num());
+	OutTraits.StateNeedsTick.Init(false, States.Num());
+	for (int32 StateIndex = 0; StateIndex < States.Num(); ++StateIndex)
+	{
+		FCompactStateTreeState const& State = States[StateIndex];
+		bool bNeedsTick = false;
+		for (int32 NodeIndex = State.TasksBegin; NodeIndex < State.TasksBegin + State.TasksNum; ++NodeIndex)
+		{
+			IsStateTask[NodeIndex] = true;
+			// bShouldCallTickOnlyOnEvents tasks only tick with events pending
+			FStateTreeTaskBase const* Task = Nodes[NodeIndex].GetPtr<FStateTreeTaskBase const>();
+			bNeedsTick |= Task && Task->bShouldCallTick;
+		}
+		OutTraits.bHasTickingTasks |= bNeedsTick;
+		for (int32 TransitionIndex = State.TransitionsBegin; TransitionIndex < State.TransitionsBegin + State.TransitionsNum; ++TransitionIndex)
+		{
+			FCompactStateTransition const* Transition = StateTree.GetTransitionFromIndex(FStateTreeIndex16(TransitionIndex));
+			bool const bTickTransition = Transition && EnumHasAnyFlags(Transition->Trigger, EStateTreeTransitionTrigger::OnTick);
+			OutTraits.bHasTickTransitions |= bTickTransition;
+			bNeedsTick |= bTickTransition;
+		}
+		OutTraits.StateNeedsTick[StateIndex] = bNeedsTick;
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		if (IsStateTask[NodeIndex]) { continue; }
+		FConstStructView const Node = Nodes[NodeIndex];
+		FStateTreeTaskBase const* Task = Node.GetPtr<FStateTreeTaskBase const>();
+		OutTraits.bHasEvaluators |= Node.GetPtr<FStateTreeEvaluatorBase const>() != nullptr;
+		OutTraits.bHasTickingGlobalTasks |= Task && Task->bShouldCallTick;
+	}
+	OutTraits.bHasTickingTasks |= OutTraits.bHasTickingGlobalTasks;
+
+#if WITH_EDITOR
+	OutTraits.bHasGameThreadOnlyNodes = false;
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		OutTraits.bHasGameThreadOnlyNodes |= !IsNodeThreadSafe(Nodes[NodeIndex].GetScriptStruct());
+	}
+#endif
+	OutTraits.bCompiled = true;
+}
+
+void UCTRLPawnStateTreeSchema::GetLinkedStateTrees(UStateTree const& StateTree, TArray<UStateTree const*>& OutLinkedStateTrees)
+{
+	for (FCompactStateTreeState const& State : StateTree.GetStates())
+	{
+		UStateTree const* LinkedAsset = State.Type == EStateTreeStateType::LinkedAsset ? State.LinkedAsset.Get() : nullptr;
+		// also stops cycles
+		if (!LinkedAsset || LinkedAsset == &StateTree || OutLinkedStateTrees.Contains(LinkedAsset)) { continue; }
+		OutLinkedStateTrees.Add(LinkedAsset);
+		GetLinkedStateTrees(*LinkedAsset, OutLinkedStateTrees);
+	}
+	OutLinkedStateTrees.Remove(&StateTree);
+}
+
+bool UCTRLPawnStateTreeSchema::IsStateTreeParallelSafe(UStateTree const& StateTree)
+{
+	auto IsSchemaParallelSafe = [](UStateTree const& Tree)
+	{
+		auto const* Schema = Cast<UCTRLPawnStateTreeSchema>(Tree.GetSchema());
+		return Schema && Schema->IsParallelSafe();
+	};
+	if (!IsSchemaParallelSafe(StateTree)) { return false; }
+	TArray<UStateTree const*> LinkedStateTrees;
+	GetLinkedStateTrees(StateTree, LinkedStateTrees);
+	return Algo::AllOf(LinkedStateTrees, [&IsSchemaParallelSafe](UStateTree const* LinkedStateTree) { return IsSchemaParallelSafe(*LinkedStateTree); });
+}
+
 #if WITH_EDITOR
+bool UCTRLPawnStateTreeSchema::IsNodeThreadSafe(UScriptStruct const* NodeStruct)
+{
+	if (!NodeStruct) { return false; }
+	if (NodeStruct->HasMetaData(TEXT("CTRLThreadSafe"))) { return true; }
+	return UCTRLStateTreeSettings::Get()->ThreadSafeNodes.Contains(FSoftObjectPath(NodeStruct));
+}
+
+void UCTRLPawnStateTreeSchema::SetCompiledResults(FCTRLStateTreeTraits const& Traits, bool const bInCompiledParallelSafe)
+{
+	Modify();
+	CompiledTraits = Traits;
+	bCompiledParallelSafe = bInCompiledParallelSafe;
+}
+
+void UCTRLPawnStateTreeSchema::AnalyzeCompiledStateTree(UStateTree const& StateTree)
+{
+	// OnPostCompile only hands out the tree as const. The schema is an instanced subobject of the tree that was just
+	// compiled (and modified), so the results are stored with it through SetCompiledResults
+	auto* Schema = const_cast<UCTRLPawnStateTreeSchema*>(Cast<UCTRLPawnStateTreeSchema>(StateTree.GetSchema()));
+	if (!Schema) { return; }
+	FCTRLStateTreeTraits Traits;
+	ComputeTraits(StateTree, Traits);
+
+	bool const bAllNodesThreadSafe = Schema->bParallelSafe && !Traits.bHasGameThreadOnlyNodes;
+	if (Schema->bParallelSafe)
+	{
+		FInstancedStructContainer const& Nodes = StateTree.GetNodes();
+		for (int32 Index = 0; Index < Nodes.Num(); ++Index)
+		{
+			UScriptStruct const* NodeStruct = Nodes[Index].GetScriptStruct();
+			if (!IsNodeThreadSafe(NodeStruct))
+			{
+				CTRLST_LOG(Error, TEXT("StateTree %s is marked parallel-safe but node %s is not thread-safe. It will tick on the game thread."), *GetNameSafe(&StateTree), *GetNameSafe(NodeStruct));
+			}
+		}
+	}
+	// linked assets run in the same instance, their nodes were validated when they were compiled
+	bool bAllLinkedParallelSafe = true;
+	if (Schema->bParallelSafe)
+	{
+		TArray<UStateTree const*> LinkedStateTrees;
+		GetLinkedStateTrees(StateTree, LinkedStateTrees);
+		for (UStateTree const* LinkedStateTree : LinkedStateTrees)
+		{
+			auto const* LinkedSchema = Cast<UCTRLPawnStateTreeSchema>(LinkedStateTree->GetSchema());
+			if (LinkedSchema && LinkedSchema->IsParallelSafe()) { continue; }
+			CTRLST_LOG(Error, TEXT("StateTree %s is marked parallel-safe but links %s, which isn't. It will tick on the game thread."), *GetNameSafe(&StateTree), *GetNameSafe(LinkedStateTree));
+			bAllLinkedParallelSafe = false;
+		}
+	}
+	Schema->SetCompiledResults(Traits, bAllNodesThreadSafe && bAllLinkedParallelSafe);
+}
+
 void UCTRLPawnStateTreeSchema::PostEditChangeChainProperty(FPropertyChangedChainEvent& PropertyChangedEvent)
 {
 	Super::PostEditChangeChainProperty(PropertyChangedEvent);
@@ -19,6 +19,49 @@ namespace CTRL::PawnStateTree::Names
 	FName const OwnerActor = TEXT("OwnerActor");
 }
 
+/*
+ * What a StateTree needs at runtime, found by UCTRLPawnStateTreeSchema::ComputeTraits when the tree is compiled.
+ * Lets the runtime pick sleep mode or the parallel tick per asset without inspecting nodes.
+ */
+USTRUCT()
+struct CTRLSTATETREE_API FCTRLStateTreeTraits
+{
+	GENERATED_BODY()
+
+	// Any task with bShouldCallTick
+	UPROPERTY(VisibleAnywhere, Category="Traits")
+	bool bHasTickingTasks = false;
+
+	// Ticking tasks outside of states, i.e. global tasks
+	UPROPERTY(VisibleAnywhere, Category="Traits")
+	bool bHasTickingGlobalTasks = false;
+
+	UPROPERTY(VisibleAnywhere, Category="Traits")
+	bool bHasEvaluators = false;
+
+	// Any transition triggered On Tick
+	UPROPERTY(VisibleAnywhere, Category="Traits")
+	bool bHasTickTransitions = false;
+
+	// Nodes that aren't thread-safe (see UCTRLPawnStateTreeSchema::IsNodeThreadSafe), e.g. the widget, input & spawn tasks.
+	// Only known in the editor, assumed outside of it
+	UPROPERTY(VisibleAnywhere, Category="Traits")
+	bool bHasGameThreadOnlyNodes = true;
+
+	// Per state index, state has ticking tasks or On Tick transitions
+	UPROPERTY()
+	TArray<bool> StateNeedsTick;
+
+	// Set once computed on compile, older assets need a recompile
+	UPROPERTY()
+	bool bCompiled = false;
+
+	// Evaluators & ticking global tasks keep every instance ticking
+	bool AlwaysNeedsTick() const { return bHasEvaluators || bHasTickingGlobalTasks; }
+	// Nothing ticks, the tree only advances on events
+	bool IsLean() const { return !bHasTickingTasks && !bHasEvaluators && !bHasTickTransitions; }
+};
+
 UCLASS(BlueprintType, EditInlineNew, CollapseCategories, meta = (DisplayName = "Pawn State Tree Schema [CTRL]", CommonSchema))
 class CTRLSTATETREE_API UCTRLPawnStateTreeSchema : public UStateTreeSchema
 {
@@ -31,6 +74,27 @@ public:
 	UClass* GetPawnActorClass() const;
 	UClass* GetOwnerActorClass() const;
 
+	// True if instances may tick on worker threads: bParallelSafe is set and every node passed validation on the last compile
+	bool IsParallelSafe() const { return bParallelSafe && bCompiledParallelSafe; }
+
+	// Assets linked from the states of StateTree, recursively, without StateTree itself. They run in the same instance
+	static void GetLinkedStateTrees(UStateTree const& StateTree, TArray<UStateTree const*>& OutLinkedStateTrees);
+	// StateTree and every asset it links have a parallel-safe pawn schema. Checked at runtime too, a linked asset may be recompiled on its own
+	static bool IsStateTreeParallelSafe(UStateTree const& StateTree);
+
+	// Traits stored by the last compile, null if the tree wasn't compiled since they were added
+	FCTRLStateTreeTraits const* GetCompiledTraits() const { return CompiledTraits.bCompiled ? &CompiledTraits : nullptr; }
+
+	// Classifies the nodes & transitions of a linked StateTree. Works at runtime too, except for bHasGameThreadOnlyNodes
+	static void ComputeTraits(UStateTree const& StateTree, FCTRLStateTreeTraits& OutTraits);
+
+#if WITH_EDITOR
+	// Node struct has CTRLThreadSafe metadata or is listed in UCTRLStateTreeSettings::ThreadSafeNodes
+	static bool IsNodeThreadSafe(UScriptStruct const* NodeStruct);
+	// Computes the traits & parallel safety of a freshly compiled StateTree and stores them on its schema
+	static void AnalyzeCompiledStateTree(UStateTree const& StateTree);
+#endif
+
 protected:
 	virtual bool IsStructAllowed(UScriptStruct const* InScriptStruct) const override;
 	virtual bool IsClassAllowed(UClass const* InScriptStruct) const override;
@@ -41,6 +105,9 @@ protected:
 	virtual void PostLoad() override;
 
 #if WITH_EDITOR
+	// Stores the compile results with Modify, so they are part of the compile's transaction & mark the asset dirty
+	void SetCompiledResults(FCTRLStateTreeTraits const& Traits, bool bInCompiledParallelSafe);
+
 	virtual void PostEditChangeChainProperty(FPropertyChangedChainEvent& PropertyChangedEvent) override;
 #endif // WITH_EDITOR
 
@@ -56,6 +123,18 @@ protected:
 	UPROPERTY(EditAnywhere, Category="Defaults")
 	TSubclassOf<AActor> OwnerActorClass;
 
+	/** Allows instances to tick on worker threads when using the batched tick. Only thread-safe nodes can be added. */
+	UPROPERTY(EditAnywhere, Category="Defaults")
+	bool bParallelSafe = false;
+
+	/** Result of the thread-safety validation on the last compile. */
+	UPROPERTY()
+	bool bCompiledParallelSafe = false;
+
+	/** Result of the compile analysis, see FCTRLStateTreeTraits. */
+	UPROPERTY(VisibleAnywhere, Category="Compiled")
+	FCTRLStateTreeTraits CompiledTraits;
+
 	/** List of named external data required by schema and provided to the state tree through the execution context. */
 	UPROPERTY()
 	TArray<FStateTreeExternalDataDesc> ContextDataDescs;
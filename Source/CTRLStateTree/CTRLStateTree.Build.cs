@@ -17,6 +17,7 @@ public class CTRLStateTree : ModuleRules
 				"FieldNotification",
 				"StateTreeModule",
 				"GameplayStateTreeModule",
+				"GameplayTags",
 			}
 		);
 
@@ -28,6 +29,7 @@ public class CTRLStateTree : ModuleRules
 				"CommonUI",
 				"CoreUObject",
 				"CTRLCore",
+				"DeveloperSettings",
 				"Engine",
 				"GameplayAbilities",
 				"GameplayStateTreeModule",
@@ -39,5 +41,17 @@ public class CTRLStateTree : ModuleRules
 				"UMG",
 			}
 		);
+
+		if (Target.bBuildEditor)
+		{
+			// the automation tests compile StateTrees in code
+			PrivateDependencyModuleNames.AddRange(
+				new string[]
+				{
+					"StateTreeEditorModule",
+					"UnrealEd",
+				}
+			);
+		}
 	}
 }
\ No newline at end of file
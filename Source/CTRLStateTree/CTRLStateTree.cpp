@@ -3,16 +3,37 @@
 
 #include "CTRLStateTree.h"
 
+#include "CTRLPawnStateTreeComponent.h"
+#include "CTRLPawnStateTreeSchema.h"
+
+#if WITH_EDITOR
+#include "StateTreeDelegates.h"
+#endif
+
 #define LOCTEXT_NAMESPACE "FCTRLStateTreeModule"
 
 DEFINE_LOG_CATEGORY(LogCTRLStateTree);
 
 void FCTRLStateTreeModule::StartupModule()
 {
+#if WITH_EDITOR
+	// context data handles may move and nodes may change when a tree is recompiled
+	OnPostCompileHandle = UE::StateTree::Delegates::OnPostCompile.AddLambda(
+		[](UStateTree const& StateTree)
+		{
+			UCTRLPawnStateTreeComponent::InvalidateContextCache(&StateTree);
+			UCTRLPawnStateTreeSchema::AnalyzeCompiledStateTree(StateTree);
+		}
+	);
+#endif
 }
 
 void FCTRLStateTreeModule::ShutdownModule()
 {
+#if WITH_EDITOR
+	UE::StateTree::Delegates::OnPostCompile.Remove(OnPostCompileHandle);
+#endif
+	UCTRLPawnStateTreeComponent::InvalidateContextCache();
 }
 
 #undef LOCTEXT_NAMESPACE
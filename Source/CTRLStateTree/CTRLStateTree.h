@@ -5,8 +5,12 @@
 
 #include "Modules/ModuleManager.h"
 
+#include "Stats/Stats.h"
+
 DECLARE_LOG_CATEGORY_EXTERN(LogCTRLStateTree, Log, All);
 
+DECLARE_STATS_GROUP(TEXT("CTRL StateTree"), STATGROUP_CTRLStateTree, STATCAT_Advanced);
+
 #define CTRLST_LOG(Verbosity, ...) UE_LOG(LogCTRLStateTree, Verbosity, ##__VA_ARGS__)
 #define CTRLST_CLOG(Cond, Verbosity, ...) UE_CLOG(Cond, LogCTRLStateTree, Verbosity, ##__VA_ARGS__)
 #define CTRLST_VLOG(Subject, Verbosity, ...) UE_VLOG_UELOG(Subject, LogCTRLStateTree, Verbosity, ##__VA_ARGS__)
@@ -18,4 +22,9 @@ public:
 	/** IModuleInterface implementation */
 	virtual void StartupModule() override;
 	virtual void ShutdownModule() override;
+
+private:
+#if WITH_EDITOR
+	FDelegateHandle OnPostCompileHandle;
+#endif
 };
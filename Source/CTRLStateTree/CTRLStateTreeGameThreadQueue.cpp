@@ -0,0 +1,54 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeGameThreadQueue.h"
+
+#include "Containers/Queue.h"
+
+#include <atomic>
+
+namespace CTRL::StateTree
+{
+	namespace Private
+	{
+		TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> GameThreadCommands;
+		// set before the workers are launched and cleared after they are joined, so workers read it without races
+		std::atomic<bool> bInParallelTick = false;
+	}
+
+	bool IsInParallelTick()
+	{
+		return Private::bInParallelTick.load(std::memory_order_relaxed);
+	}
+
+	FParallelTickScope::FParallelTickScope()
+	{
+		check(IsInGameThread());
+		ensure(!Private::bInParallelTick.exchange(true));
+	}
+
+	FParallelTickScope::~FParallelTickScope()
+	{
+		Private::bInParallelTick = false;
+	}
+
+	void RunOnGameThread(TUniqueFunction<void()>&& Command)
+	{
+		if (IsInGameThread() && !IsInParallelTick())
+		{
+			Command();
+			return;
+		}
+		Private::GameThreadCommands.Enqueue(MoveTemp(Command));
+	}
+
+	void FlushGameThreadCommands()
+	{
+		check(IsInGameThread() && !IsInParallelTick());
+		TUniqueFunction<void()> Command;
+		while (Private::GameThreadCommands.Dequeue(Command))
+		{
+			Command();
+		}
+	}
+}
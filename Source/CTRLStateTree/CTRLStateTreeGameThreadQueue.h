@@ -0,0 +1,34 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+namespace CTRL::StateTree
+{
+	/**
+	 * Whether the parallel StateTree tick is running, see FParallelTickScope.
+	 * ParallelFor also runs items on the game thread, so tasks check this instead of IsInGameThread to know whether
+	 * they may touch UObjects outside their instance data.
+	 */
+	CTRLSTATETREE_API bool IsInParallelTick();
+
+	// Marks the parallel StateTree tick for IsInParallelTick. Game thread only, not reentrant
+	struct CTRLSTATETREE_API FParallelTickScope
+	{
+		FParallelTickScope();
+		~FParallelTickScope();
+		UE_NONCOPYABLE(FParallelTickScope);
+	};
+
+	/**
+	 * Runs Command immediately when called on the game thread outside the parallel StateTree tick.
+	 * Otherwise (e.g. from a task running in the parallel StateTree tick) queues it until FlushGameThreadCommands.
+	 * Commands run in the order they were queued.
+	 */
+	CTRLSTATETREE_API void RunOnGameThread(TUniqueFunction<void()>&& Command);
+
+	// Runs all queued commands. Game thread only.
+	CTRLSTATETREE_API void FlushGameThreadCommands();
+}
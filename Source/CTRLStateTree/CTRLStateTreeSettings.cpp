@@ -0,0 +1,49 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeSettings.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeSettings)
+
+UCTRLStateTreeSettings::UCTRLStateTreeSettings()
+{
+	LODBands = {
+		{2000.f, 0.f, false},
+		{5000.f, 0.1f, false},
+		{15000.f, 0.5f, false},
+		{30000.f, 1.f, false},
+		{UE_BIG_NUMBER, 0.f, true},
+	};
+	ThreadSafeNodes = {
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeDelayTask")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeCompareIntCondition")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeCompareFloatCondition")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeCompareBoolCondition")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeCompareEnumCondition")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeObjectIsValidCondition")),
+		FSoftObjectPath(TEXT("/Script/StateTreeModule.StateTreeObjectEqualsCondition")),
+	};
+}
+
+int32 UCTRLStateTreeSettings::GetLODBandIndex(float const Distance) const
+{
+	for (int32 Index = 0; Index < LODBands.Num(); ++Index)
+	{
+		if (Distance <= LODBands[Index].MaxDistance)
+		{
+			return Index;
+		}
+	}
+	return LODBands.Num() - 1;
+}
+
+#if WITH_EDITOR
+void UCTRLStateTreeSettings::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	if (PropertyChangedEvent.GetMemberPropertyName() == GET_MEMBER_NAME_CHECKED(UCTRLStateTreeSettings, LODBands))
+	{
+		LODBands.StableSort([](FCTRLStateTreeLODBand const& A, FCTRLStateTreeLODBand const& B) { return A.MaxDistance < B.MaxDistance; });
+	}
+}
+#endif
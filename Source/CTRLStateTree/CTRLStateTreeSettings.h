@@ -0,0 +1,98 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Engine/DeveloperSettings.h"
+
+#include "CTRLStateTreeSettings.generated.h"
+
+class UStateTree;
+
+/*
+ * Tick rate for pawn state trees within a distance of the nearest player view point.
+ */
+USTRUCT(BlueprintType)
+struct CTRLSTATETREE_API FCTRLStateTreeLODBand
+{
+	GENERATED_BODY()
+
+	// Band applies to state trees closer than this to a player view point
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", Units="cm"))
+	float MaxDistance = 0.f;
+
+	// Tick interval while in this band. 0 ticks every frame
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, meta=(ClampMin="0", Units="s", EditCondition="!bDormant"))
+	float TickInterval = 0.f;
+
+	// Stop ticking entirely while in this band. Still woken for a frame when a StateTree event is queued
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bDormant = false;
+};
+
+/*
+ * Project settings for CTRL StateTree runtime features.
+ */
+UCLASS(Config=Game, DefaultConfig, DisplayName="CTRL StateTree")
+class CTRLSTATETREE_API UCTRLStateTreeSettings : public UDeveloperSettings
+{
+	GENERATED_BODY()
+
+public:
+	UCTRLStateTreeSettings();
+
+	static UCTRLStateTreeSettings const* Get() { return GetDefault<UCTRLStateTreeSettings>(); }
+
+	virtual FName GetCategoryName() const override { return TEXT("Plugins"); }
+
+	// Distance bands for pawn state trees using significance LOD, sorted by MaxDistance.
+	// State trees further than the last band's MaxDistance use the last band.
+	UPROPERTY(Config, EditAnywhere, Category="LOD")
+	TArray<FCTRLStateTreeLODBand> LODBands;
+
+	// State trees whose owner was not rendered recently score as if this much further away
+	UPROPERTY(Config, EditAnywhere, Category="LOD", meta=(ClampMin="1"))
+	float NotRenderedDistanceScale = 2.f;
+
+	// How long ago the owner must have been rendered to count as visible
+	UPROPERTY(Config, EditAnywhere, Category="LOD", meta=(ClampMin="0", Units="s"))
+	float RecentlyRenderedTolerance = 0.2f;
+
+	// Returns the band index for the (scaled) distance to the nearest view point
+	int32 GetLODBandIndex(float Distance) const;
+
+	// Tick batched instances of parallel-safe StateTrees (see UCTRLPawnStateTreeSchema::bParallelSafe) across worker threads
+	UPROPERTY(Config, EditAnywhere, Category="Tick")
+	bool bParallelTick = true;
+
+	// Minimum number of instances each worker picks up at once in the parallel tick
+	UPROPERTY(Config, EditAnywhere, Category="Tick", meta=(ClampMin="1", EditCondition="bParallelTick"))
+	int32 ParallelTickMinBatchSize = 8;
+
+	// Nodes without the CTRLThreadSafe metadata (e.g. engine or other plugin nodes) that are safe to run in the parallel tick
+	UPROPERTY(Config, EditAnywhere, Category="Tick", meta=(AllowedClasses="/Script/CoreUObject.ScriptStruct"))
+	TArray<FSoftObjectPath> ThreadSafeNodes;
+
+	// Time per frame spent starting queued pawn state trees (see UCTRLPawnStateTreeComponent::bUseStartupScheduler). At least one starts per frame
+	UPROPERTY(Config, EditAnywhere, Category="Startup", meta=(ClampMin="0", Units="ms"))
+	float StartupBudgetMs = 2.f;
+
+	// Queued pawn state trees start regardless of the budget once they waited this long
+	UPROPERTY(Config, EditAnywhere, Category="Startup", meta=(ClampMin="0", Units="s"))
+	float MaxStartLatency = 1.f;
+
+	// Reset instance data storages kept per StateTree asset for reuse by the next StartLogic. 0 (default) disables pooling,
+	// set it for projects that respawn or restart many pawns running the same trees
+	UPROPERTY(Config, EditAnywhere, Category="Pool", meta=(ClampMin="0"))
+	int32 InstanceDataPoolSize = 0;
+
+	// Loaded & warmed up by UCTRLStateTreeLoadingSubsystem at world init, and kept loaded while the world exists
+	UPROPERTY(Config, EditAnywhere, Category="Loading")
+	TArray<TSoftObjectPtr<UStateTree>> PreloadStateTrees;
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+};
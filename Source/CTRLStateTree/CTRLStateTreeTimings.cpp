@@ -0,0 +1,177 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeTimings.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+
+#include "HAL/IConsoleManager.h"
+
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#include <atomic>
+
+CSV_DEFINE_CATEGORY_MODULE(CTRLSTATETREE_API, CTRLStateTree, true);
+
+namespace CTRL::StateTree::Timings
+{
+	namespace Private
+	{
+		// caps memory when recording is left on, about 4MB per timing
+		constexpr int32 MaxSamples = 1 << 20;
+
+		bool bRecordTimings = false;
+		FAutoConsoleVariableRef CVarRecordTimings(
+			TEXT("CTRL.StateTree.RecordTimings"),
+			bRecordTimings,
+			TEXT("Records the duration of every pawn StateTree StartLogic, tick, possession change & StopLogic for CTRL.StateTree.DumpTimings.")
+		);
+
+		// Samples of one thread. Written from worker threads by the parallel batched tick, so every thread appends to
+		// its own buffer and the lock is only contended while dumping or resetting
+		struct FThreadSamples
+		{
+			FCriticalSection Lock;
+			TArray<float> Samples[static_cast<int32>(ETiming::Num)];
+		};
+
+		// registered once per thread
+		FCriticalSection ThreadSamplesLock;
+		TArray<TSharedPtr<FThreadSamples, ESPMode::ThreadSafe>> AllThreadSamples;
+		std::atomic<int32> NumSamples[static_cast<int32>(ETiming::Num)];
+
+		FThreadSamples& GetThreadSamples()
+		{
+			thread_local TSharedPtr<FThreadSamples, ESPMode::ThreadSafe> ThreadSamples;
+			if (!ThreadSamples)
+			{
+				ThreadSamples = MakeShared<FThreadSamples, ESPMode::ThreadSafe>();
+				FScopeLock Lock(&ThreadSamplesLock);
+				AllThreadSamples.Add(ThreadSamples);
+			}
+			return *ThreadSamples;
+		}
+
+		double GetPercentile(TArray<float> const& SortedSamples, double const Percentile)
+		{
+			int32 const Index = FMath::Clamp(FMath::CeilToInt32(Percentile * SortedSamples.Num()) - 1, 0, SortedSamples.Num() - 1);
+			return SortedSamples[Index];
+		}
+
+		FAutoConsoleCommand DumpTimingsCommand(
+			TEXT("CTRL.StateTree.DumpTimings"),
+			TEXT("Writes the samples recorded with CTRL.StateTree.RecordTimings as CSV. Optional argument: file path, defaults to Saved/Profiling/CTRLStateTree."),
+			FConsoleCommandWithArgsDelegate::CreateLambda(
+				[](TArray<FString> const& Args)
+				{
+					FString const FilePath = Args.IsEmpty()
+						? FPaths::ProfilingDir() / TEXT("CTRLStateTree") / FString::Printf(TEXT("Timings-%s.csv"), *FDateTime::Now().ToString())
+						: Args[0];
+					if (WriteSamplesCsv(FilePath))
+					{
+						CTRLST_LOG(Display, TEXT("Wrote StateTree timings to %s"), *FilePath);
+					}
+					else
+					{
+						CTRLST_LOG(Error, TEXT("Failed to write StateTree timings to %s"), *FilePath);
+					}
+				}
+			)
+		);
+
+		FAutoConsoleCommand ResetTimingsCommand(
+			TEXT("CTRL.StateTree.ResetTimings"),
+			TEXT("Drops the samples recorded with CTRL.StateTree.RecordTimings."),
+			FConsoleCommandDelegate::CreateStatic(&ResetSamples)
+		);
+	}
+
+	TCHAR const* LexToString(ETiming const Timing)
+	{
+		switch (Timing)
+		{
+		case ETiming::StartLogic: return TEXT("StartLogic");
+		case ETiming::Tick: return TEXT("Tick");
+		case ETiming::PossessionChange: return TEXT("PossessionChange");
+		case ETiming::StopLogic: return TEXT("StopLogic");
+		default: return TEXT("Unknown");
+		}
+	}
+
+	bool IsRecording()
+	{
+		return Private::bRecordTimings;
+	}
+
+	void SetRecording(bool const bRecording)
+	{
+		Private::bRecordTimings = bRecording;
+	}
+
+	void AddSample(ETiming const Timing, double const Seconds)
+	{
+		int32 const TimingIndex = static_cast<int32>(Timing);
+		// the cap is shared by all threads, so it may overshoot by one sample per thread
+		if (Private::NumSamples[TimingIndex].fetch_add(1, std::memory_order_relaxed) >= Private::MaxSamples) { return; }
+		Private::FThreadSamples& ThreadSamples = Private::GetThreadSamples();
+		FScopeLock Lock(&ThreadSamples.Lock);
+		ThreadSamples.Samples[TimingIndex].Add(static_cast<float>(Seconds * 1000000.));
+	}
+
+	void ResetSamples()
+	{
+		FScopeLock Lock(&Private::ThreadSamplesLock);
+		for (TSharedPtr<Private::FThreadSamples, ESPMode::ThreadSafe> const& ThreadSamples : Private::AllThreadSamples)
+		{
+			FScopeLock ThreadLock(&ThreadSamples->Lock);
+			for (TArray<float>& TimingSamples : ThreadSamples->Samples)
+			{
+				TimingSamples.Empty();
+			}
+		}
+		for (std::atomic<int32>& Count : Private::NumSamples)
+		{
+			Count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	bool WriteSamplesCsv(FString const& FilePath)
+	{
+		FString Csv = TEXT("Timing,Count,MeanUs,P50Us,P90Us,P99Us,MaxUs\n");
+		TArray<float> Sorted;
+		for (int32 Index = 0; Index < static_cast<int32>(ETiming::Num); ++Index)
+		{
+			Sorted.Reset();
+			{
+				FScopeLock Lock(&Private::ThreadSamplesLock);
+				for (TSharedPtr<Private::FThreadSamples, ESPMode::ThreadSafe> const& ThreadSamples : Private::AllThreadSamples)
+				{
+					FScopeLock ThreadLock(&ThreadSamples->Lock);
+					Sorted.Append(ThreadSamples->Samples[Index]);
+				}
+			}
+			if (Sorted.IsEmpty()) { continue; }
+			Sorted.Sort();
+
+			double Total = 0.;
+			for (float const Sample : Sorted)
+			{
+				Total += Sample;
+			}
+			Csv += FString::Printf(
+				TEXT("%s,%d,%.3f,%.3f,%.3f,%.3f,%.3f\n"),
+				LexToString(static_cast<ETiming>(Index)),
+				Sorted.Num(),
+				Total / Sorted.Num(),
+				Private::GetPercentile(Sorted, 0.5),
+				Private::GetPercentile(Sorted, 0.9),
+				Private::GetPercentile(Sorted, 0.99),
+				Sorted.Last()
+			);
+		}
+		return FFileHelper::SaveStringToFile(Csv, *FilePath);
+	}
+}
@@ -0,0 +1,59 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(CTRLSTATETREE_API, CTRLStateTree);
+
+namespace CTRL::StateTree::Timings
+{
+	enum class ETiming : uint8
+	{
+		StartLogic,
+		Tick,
+		PossessionChange,
+		StopLogic,
+		Num
+	};
+
+	CTRLSTATETREE_API TCHAR const* LexToString(ETiming Timing);
+
+	// Per call samples are only recorded while CTRL.StateTree.RecordTimings is set
+	CTRLSTATETREE_API bool IsRecording();
+	CTRLSTATETREE_API void SetRecording(bool bRecording);
+	CTRLSTATETREE_API void AddSample(ETiming Timing, double Seconds);
+	CTRLSTATETREE_API void ResetSamples();
+	// Writes count, mean & percentiles (in microseconds) per timing as CSV, returns false if the file could not be written
+	CTRLSTATETREE_API bool WriteSamplesCsv(FString const& FilePath);
+
+	struct FScopedTiming
+	{
+		explicit FScopedTiming(ETiming const InTiming)
+			: Timing(InTiming)
+			, StartTime(IsRecording() ? FPlatformTime::Seconds() : 0.)
+		{
+		}
+
+		~FScopedTiming()
+		{
+			if (StartTime > 0.)
+			{
+				AddSample(Timing, FPlatformTime::Seconds() - StartTime);
+			}
+		}
+
+	private:
+		ETiming Timing;
+		double StartTime;
+	};
+}
+
+// Cycle stat, CSV profiler stat (-csvprofile) and per call sample for CTRL.StateTree.DumpTimings
+#define CTRLST_SCOPED_TIMING(Timing, Stat) \
+	SCOPE_CYCLE_COUNTER(Stat); \
+	CSV_SCOPED_TIMING_STAT(CTRLStateTree, Timing); \
+	CTRL::StateTree::Timings::FScopedTiming ANONYMOUS_VARIABLE(CTRLStateTreeTiming)(CTRL::StateTree::Timings::ETiming::Timing)
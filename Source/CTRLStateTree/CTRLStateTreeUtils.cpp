@@ -1,5 +1,9 @@
 ﻿#include "CTRLStateTreeUtils.h"
 
+#include "Engine/World.h"
+
+#include "GameFramework/PlayerController.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeUtils)
 
 FStateTreePropertyPath UCTRLStateTreeUtils::GetStructPropertyPath(FGuid const& ID, FName const A, FName const B)
@@ -8,3 +12,17 @@ FStateTreePropertyPath UCTRLStateTreeUtils::GetStructPropertyPath(FGuid const& I
 	Path.FromString(FString::Printf(TEXT("%s.%s"), *A.ToString(), *B.ToString()));
 	return Path;
 }
+
+void UCTRLStateTreeUtils::GetPlayerViewLocations(UWorld const* World, TArray<FVector>& OutLocations)
+{
+	if (!World) { return; }
+	for (auto It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		APlayerController const* PC = It->Get();
+		if (!IsValid(PC)) { continue; }
+		FVector Location;
+		FRotator Rotation;
+		PC->GetPlayerViewPoint(Location, Rotation);
+		OutLocations.Add(Location);
+	}
+}
@@ -110,4 +110,7 @@ public:
 	}
 
 	static FStateTreePropertyPath GetStructPropertyPath(FGuid const& ID, FName A, FName B);
+
+	// Appends the view point location of every player controller in World (local players, and remote players on a server)
+	static void GetPlayerViewLocations(UWorld const* World, TArray<FVector>& OutLocations);
 };
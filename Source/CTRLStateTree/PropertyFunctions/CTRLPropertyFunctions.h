@@ -163,7 +163,7 @@ struct CTRLSTATETREE_API FCTRLRandomIntPropertyFunction : public FCTRLPropertyFu
 /*
  * Convert an FString to an FText
  */
-USTRUCT(meta=(DisplayName = "String To Text [CTRL]", Category = "Object"))
+USTRUCT(meta=(DisplayName = "String To Text [CTRL]", Category = "Object", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLStringToTextPropertyFunction : public FCTRLPropertyFunctionBase
 {
 	GENERATED_BODY()
@@ -182,7 +182,7 @@ struct CTRLSTATETREE_API FCTRLStringToTextPropertyFunction : public FCTRLPropert
 /*
  * Convert an FString to an FName
  */
-USTRUCT(meta=(DisplayName = "String To Name [CTRL]", Category = "Object"))
+USTRUCT(meta=(DisplayName = "String To Name [CTRL]", Category = "Object", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLStringToNamePropertyFunction : public FCTRLPropertyFunctionBase
 {
 	GENERATED_BODY()
@@ -201,7 +201,7 @@ struct CTRLSTATETREE_API FCTRLStringToNamePropertyFunction : public FCTRLPropert
 /*
  * Convert a bool to a string
  */
-USTRUCT(meta=(DisplayName = "Bool To String [CTRL]", Category = "Object"))
+USTRUCT(meta=(DisplayName = "Bool To String [CTRL]", Category = "Object", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLBoolToStringPropertyFunction : public FCTRLPropertyFunctionBase
 {
 	GENERATED_BODY()
@@ -221,7 +221,7 @@ struct CTRLSTATETREE_API FCTRLBoolToStringPropertyFunction : public FCTRLPropert
  * Check if an object is valid
  * Same as built-in ObjectIsValid, but with fixed description when inverted
  */
-USTRUCT(meta=(DisplayName = "Object Is Valid [CTRL]", Category = "Object"))
+USTRUCT(meta=(DisplayName = "Object Is Valid [CTRL]", Category = "Object", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLObjectIsValidPropertyFunction : public FCTRLPropertyFunctionBase
 {
 	GENERATED_BODY()
@@ -3,6 +3,7 @@
 #include "StateTreeExecutionContext.h"
 #include "TimerManager.h"
 
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLChangeInputConfigTask)
@@ -37,11 +38,28 @@ EStateTreeRunStatus FCTRLChangeInputConfigTask::EnterState(FStateTreeExecutionCo
 		CTRLST_LOG(Error, TEXT("FCTRLChangeInputConfigTask: PlayerController is invalid %s"), *GetNameSafe(InstanceData.PlayerController));
 		return EStateTreeRunStatus::Failed;
 	}
-	auto const ChangeInputConfigSubsystem = UCTRLChangeInputConfigSubsystem::Get(InstanceData.PlayerController);
-	if (!ChangeInputConfigSubsystem) { return EStateTreeRunStatus::Failed; }
 	ensure(!InstanceData.InputConfigHandle.IsSet());
 	auto const InputConfig = GetInputConfig(Context.GetInstanceDataPtr<FCTRLChangeInputConfigTaskData>(*this));
-	InstanceData.InputConfigHandle = ChangeInputConfigSubsystem->PushInputConfig(InputConfig);
+	if (!CTRL::StateTree::IsInParallelTick())
+	{
+		auto const ChangeInputConfigSubsystem = UCTRLChangeInputConfigSubsystem::Get(InstanceData.PlayerController);
+		if (!ChangeInputConfigSubsystem) { return EStateTreeRunStatus::Failed; }
+		InstanceData.InputConfigHandle = ChangeInputConfigSubsystem->PushInputConfig(InputConfig);
+		return EStateTreeRunStatus::Running;
+	}
+
+	// parallel tick, hand out the handle now and resolve the subsystem & push once back on the game thread
+	FGuid const Handle = FGuid::NewGuid();
+	InstanceData.InputConfigHandle = Handle;
+	CTRL::StateTree::RunOnGameThread(
+		[WeakPlayerController = MakeWeakObjectPtr(InstanceData.PlayerController.Get()), InputConfig, Handle]()
+		{
+			if (auto const Subsystem = UCTRLChangeInputConfigSubsystem::Get(WeakPlayerController.Get()))
+			{
+				Subsystem->PushInputConfig(InputConfig, Handle);
+			}
+		}
+	);
 	return EStateTreeRunStatus::Running;
 }
 
@@ -61,10 +79,17 @@ void FCTRLChangeInputConfigTask::ExitState(FStateTreeExecutionContext& Context,
 		return;
 	}
 
-	auto const ChangeInputConfigSubsystem = UCTRLChangeInputConfigSubsystem::Get(InstanceData.PlayerController);
-	if (!ChangeInputConfigSubsystem) return;
 	auto const Handle = InstanceData.InputConfigHandle.GetValue();
-	ChangeInputConfigSubsystem->PopInputConfig(Handle);
+	// runs right away outside the parallel tick
+	CTRL::StateTree::RunOnGameThread(
+		[WeakPlayerController = MakeWeakObjectPtr(InstanceData.PlayerController.Get()), Handle]()
+		{
+			if (auto const Subsystem = UCTRLChangeInputConfigSubsystem::Get(WeakPlayerController.Get()))
+			{
+				Subsystem->PopInputConfig(Handle);
+			}
+		}
+	);
 }
 
 EDataValidationResult FCTRLChangeInputConfigTask::Compile(FStateTreeDataView const InstanceDataView, TArray<FText>& ValidationMessages)
@@ -29,6 +29,7 @@ struct FCTRLChangeInputConfigTaskData
 	TOptional<FGuid> InputConfigHandle;
 };
 
+// Game thread only, a tree using it ticks on the game thread
 USTRUCT(BlueprintType, DisplayName = "Change Input [CTRL]", meta = (Category = "Input"))
 struct FCTRLChangeInputConfigTask : public FCTRLStateTreeCommonBaseTask
 {
@@ -7,10 +7,14 @@
 
 #include "Blueprint/UserWidget.h"
 
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
 
 #include "Engine/Engine.h"
 
+#include "StateTreeExecutionContext.h"
+
 #include "VisualLogger/VisualLogger.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLCreateWidgetTask)
@@ -45,7 +49,15 @@ void UCTRLCreateWidgetTaskData::Destruct()
 void FCTRLCreateWidgetTask::ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
 	auto& InstanceData = Context.GetInstanceData<UInstanceDataType>(*this);
-	InstanceData.Destruct();
+	CTRL::StateTree::RunOnGameThread(
+		[WeakInstanceData = MakeWeakObjectPtr(&InstanceData)]()
+		{
+			if (auto const Data = WeakInstanceData.Get())
+			{
+				Data->Destruct();
+			}
+		}
+	);
 	Super::ExitState(Context, Transition);
 }
 
@@ -73,29 +85,50 @@ FText FCTRLCreateWidgetTask::GetDescription(FGuid const& ID, FStateTreeDataView
 EStateTreeRunStatus FCTRLCreateWidgetTask::EnterState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
 	auto& InstanceData = Context.GetInstanceData<UInstanceDataType>(*this);
-	InstanceData.SetCachedInstanceDataFromContext(Context);
-	// SetCachedInstanceDataFromContext(Context);
-	if (!bShouldStateChangeOnReselect && Transition.ChangeType == EStateTreeStateChangeType::Sustained)
-	{
-		// Unreal has fucked up if this happens, so just exit with what it was going to do anyway
-		return EStateTreeRunStatus::Running;
-	}
+	bool const bSustained = !bShouldStateChangeOnReselect && Transition.ChangeType == EStateTreeStateChangeType::Sustained;
 
-	if (!IsValid(InstanceData.TargetPlayerController))
-	{
-		CTRLST_LOG(Error, TEXT("TargetPlayerPawn is invalid %s"), *GetNameSafe(InstanceData.TargetPlayerController));
-		return EStateTreeRunStatus::Failed;
-	}
-	if (!IsValid(InstanceData.WidgetTemplate))
+	if (CTRL::StateTree::IsInParallelTick())
 	{
-		CTRLST_LOG(Error, TEXT("WidgetTemplate is invalid %s"), *GetNameSafe(InstanceData.WidgetTemplate));
-		return EStateTreeRunStatus::Failed;
+		// parallel tick, the instance data and widgets are only touched on the game thread.
+		// Only plain values are read from the context here, a failed Setup finishes the task on the next tick
+		TWeakPtr<FStateTreeInstanceStorage> WeakInstanceStorage;
+		if (FStateTreeInstanceData* StateTreeInstanceData = Context.GetMutableInstanceData())
+		{
+			WeakInstanceStorage = StateTreeInstanceData->GetWeakMutableStorage();
+		}
+		FStateTreeExecutionFrame const* CurrentlyProcessedFrame = Context.GetCurrentlyProcessedFrame();
+		check(CurrentlyProcessedFrame);
+
+		CTRL::StateTree::RunOnGameThread(
+			[
+				WeakInstanceData = MakeWeakObjectPtr(&InstanceData),
+				WeakContext = Context.MakeWeakExecutionContext(),
+				WeakInstanceStorage = MoveTemp(WeakInstanceStorage),
+				WeakOwner = MakeWeakObjectPtr(Context.GetOwner()),
+				State = Context.GetCurrentlyProcessedState(),
+				WeakFrameStateTree = MakeWeakObjectPtr(CurrentlyProcessedFrame->StateTree.Get()),
+				FrameRootState = CurrentlyProcessedFrame->RootState,
+				bSustained
+			]()
+			{
+				auto const Data = WeakInstanceData.Get();
+				if (!Data) { return; }
+				Data->SetCachedInstanceData(WeakInstanceStorage, WeakOwner.Get(), State, WeakFrameStateTree.Get(), FrameRootState);
+				if (bSustained) { return; }
+				if (!Data->Setup())
+				{
+					WeakContext.FinishTask(EStateTreeFinishTaskType::Failed);
+					UCTRLPawnStateTreeComponent::WakeUpStateTrees(WeakOwner.Get());
+				}
+			}
+		);
+		return bSustained ? EStateTreeRunStatus::Running : Super::EnterState(Context, Transition);
 	}
 
-	if (InstanceData.Widget)
+	InstanceData.SetCachedInstanceDataFromContext(Context);
+	if (bSustained)
 	{
-		// this shouldn't happen, but just in case
-		CTRLST_LOG(Warning, TEXT("Widget is already created %s"), *GetNameSafe(InstanceData.Widget));
+		// Unreal has fucked up if this happens, so just exit with what it was going to do anyway
 		return EStateTreeRunStatus::Running;
 	}
 
@@ -109,6 +142,23 @@ EStateTreeRunStatus FCTRLCreateWidgetTask::EnterState(FStateTreeExecutionContext
 
 bool UCTRLCreateWidgetTaskData::Setup()
 {
+	if (!IsValid(TargetPlayerController))
+	{
+		CTRLST_LOG(Error, TEXT("TargetPlayerPawn is invalid %s"), *GetNameSafe(TargetPlayerController));
+		return false;
+	}
+	if (!IsValid(WidgetTemplate))
+	{
+		CTRLST_LOG(Error, TEXT("WidgetTemplate is invalid %s"), *GetNameSafe(WidgetTemplate));
+		return false;
+	}
+	if (Widget)
+	{
+		// this shouldn't happen, but just in case
+		CTRLST_LOG(Warning, TEXT("Widget is already created %s"), *GetNameSafe(Widget));
+		return true;
+	}
+
 	// Create the widget.
 	Widget = DuplicateObject<UUserWidget>(WidgetTemplate, TargetPlayerController);
 	if (!Widget)
@@ -145,22 +195,36 @@ void UCTRLCreateWidgetTaskData::SendEvent(FStateTreeEvent const& Event) const
 		return;
 	}
 	InstanceStorage->GetMutableEventQueue().SendEvent(CachedOwner, Event.Tag, Event.Payload, Event.Origin);
+	UCTRLPawnStateTreeComponent::WakeUpStateTrees(CachedOwner);
 }
 
 void UCTRLCreateWidgetTaskData::SetCachedInstanceDataFromContext(FStateTreeExecutionContext const& Context) const
 {
+	TWeakPtr<FStateTreeInstanceStorage> InstanceStorage;
 	if (FStateTreeInstanceData* InstanceData = Context.GetMutableInstanceData())
 	{
-		WeakInstanceStorage = InstanceData->GetWeakMutableStorage();
+		InstanceStorage = InstanceData->GetWeakMutableStorage();
 	}
-	CachedState = Context.GetCurrentlyProcessedState();
-	CachedOwner = Context.GetOwner();
 
 	FStateTreeExecutionFrame const* CurrentlyProcessedFrame = Context.GetCurrentlyProcessedFrame();
 	check(CurrentlyProcessedFrame);
 
-	CachedFrameStateTree = CurrentlyProcessedFrame->StateTree;
-	CachedFrameRootState = CurrentlyProcessedFrame->RootState;
+	SetCachedInstanceData(InstanceStorage, Context.GetOwner(), Context.GetCurrentlyProcessedState(), CurrentlyProcessedFrame->StateTree, CurrentlyProcessedFrame->RootState);
+}
+
+void UCTRLCreateWidgetTaskData::SetCachedInstanceData(
+	TWeakPtr<FStateTreeInstanceStorage> const& InWeakInstanceStorage,
+	UObject* InOwner,
+	FStateTreeStateHandle const InState,
+	UStateTree const* InFrameStateTree,
+	FStateTreeStateHandle const InFrameRootState
+) const
+{
+	WeakInstanceStorage = InWeakInstanceStorage;
+	CachedOwner = InOwner;
+	CachedState = InState;
+	CachedFrameStateTree = InFrameStateTree;
+	CachedFrameRootState = InFrameRootState;
 }
 
 void UCTRLCreateWidgetTaskData::ClearCachedInstanceData() const
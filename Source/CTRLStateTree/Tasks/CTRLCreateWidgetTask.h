@@ -57,6 +57,13 @@ public:
 	void SendEvent(FStateTreeEvent const& Event) const;
 
 	void SetCachedInstanceDataFromContext(FStateTreeExecutionContext const& Context) const;
+	void SetCachedInstanceData(
+		TWeakPtr<FStateTreeInstanceStorage> const& InWeakInstanceStorage,
+		UObject* InOwner,
+		FStateTreeStateHandle InState,
+		UStateTree const* InFrameStateTree,
+		FStateTreeStateHandle InFrameRootState
+	) const;
 
 	void ClearCachedInstanceData() const;
 	/** Cached instance data while the node is active. */
@@ -77,6 +84,11 @@ public:
 	mutable FStateTreeStateHandle CachedState;
 };
 
+/**
+ * Creates a widget from the template on enter and removes it on exit.
+ * Game thread only, a tree using it ticks on the game thread. If a project lists it under Thread Safe Nodes anyway, the widget
+ * is created on the game thread after the parallel phase, so the outputs are only valid from the next tick.
+ */
 USTRUCT(BlueprintType, Blueprintable, DisplayName = "Create Widget Task [CTRL]", meta=(Category="UI"))
 struct CTRLSTATETREE_API FCTRLCreateWidgetTask : public FCTRLStateTreeCommonBaseTask
 {
@@ -4,11 +4,12 @@
 #include "CTRLGasEventToStateTreeEventTask.h"
 
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "StateTreeExecutionContext.h"
 
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
 #include "CTRLStateTree/CTRLStateTree.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
+#include "CTRLStateTree/Utils/CTRLAbilitySystemCacheSubsystem.h"
 
 #include "Engine/World.h"
 
@@ -16,20 +17,34 @@
 
 #define LOCTEXT_NAMESPACE "GameplayEventToStateTreeEventTask"
 
-void UCTRLStateTreeEventBridge::GameplayEventCallback(FGameplayEventData const* GameplayEventData) const
-{
-	if (!GameplayEventData) { return; }
-	GameplayEventContainerCallback(GameplayEventData->EventTag, GameplayEventData);
-}
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Dropped Gameplay Events"), STAT_CTRLStateTree_DroppedGameplayEvents, STATGROUP_CTRLStateTree);
 
-void UCTRLStateTreeEventBridge::GameplayEventContainerCallback(FGameplayTag const GameplayTag, FGameplayEventData const* GameplayEventData) const
+namespace CTRL::GasEventToStateTreeEvent::Private
 {
-	if (!GameplayEventData || !GameplayTag.IsValid()) { return; }
-	if (EventReceived.IsBound())
+	// queue slots kept free for high priority events
+	constexpr int32 NumReservedEvents = 8;
+
+	int32 GetMaxQueuedEvents(ECTRLGasEventPriority const Priority)
 	{
-		FGameplayEventData TempPayload = *GameplayEventData;
-		TempPayload.EventTag = GameplayTag;
-		EventReceived.Execute(MoveTemp(TempPayload));
+		switch (Priority)
+		{
+			case ECTRLGasEventPriority::Low:
+				return FStateTreeEventQueue::MaxActiveEvents / 2;
+			case ECTRLGasEventPriority::Normal:
+				return FStateTreeEventQueue::MaxActiveEvents - NumReservedEvents;
+			default:
+				return FStateTreeEventQueue::MaxActiveEvents;
+		}
+	}
+
+	void RemoveDelegate(FCTRLGasEventToStateTreeEventTaskData& Data)
+	{
+		if (!Data.DelegateHandle.IsValid()) { return; }
+		if (UAbilitySystemComponent* AbilitySystem = Data.AbilitySystem.Get())
+		{
+			AbilitySystem->RemoveGameplayEventTagContainerDelegate(FGameplayTagContainer(), Data.DelegateHandle);
+		}
+		Data.DelegateHandle.Reset();
 	}
 }
 
@@ -48,62 +63,8 @@ EDataValidationResult FCTRLGasEventToStateTreeEventTask::Compile(FStateTreeDataV
 	return CombineDataValidationResults(SuperResult, Result);
 }
 
-UCTRLStateTreeEventBridge* FCTRLGasEventToStateTreeEventTask::MakeBridge(FStateTreeExecutionContext const& Context) const
-{
-	auto World = Context.GetWorld();
-	if (!World) { return nullptr; }
-	auto& Data = Context.GetInstanceData<FInstanceDataType>(*this);
-	if (!Data.Actor.IsValid()) { return nullptr; }
-	auto Bridge = Data.Bridge;
-	if (Bridge)
-	{
-		Bridge->EventReceived.Unbind();
-		Bridge->RemoveFromRoot();
-		Bridge = nullptr;
-	}
-
-	auto const Actor = Data.Actor;
-	Bridge = NewObject<UCTRLStateTreeEventBridge>(Data.Actor.Get(), NAME_None, RF_Transient);
-	
-	// Data.OnActorDestroyedHandle = World->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateWeakLambda(
- //        Actor.Get(),
- //        [&Data](AActor* DestroyedActor)
- //        {
- //        	if (!Data.Bridge) return;
- //        	if (DestroyedActor == Data.Bridge->GetOuter())
- //        	{
-	// 				Data.Bridge->EventReceived.Unbind();
-	// 				Data.Bridge = nullptr;
- //        	}
- //        }
- //    ));
-	FStateTreeEventQueue& EventQueue = Context.GetMutableEventQueue();
-	FString MsgPart = FString::Printf(TEXT("%s. Sending → StateTree %s"), *GetNameSafe(Actor.Get()), *GetNameSafe(Context.GetStateTree()));
-	Bridge->EventReceived.BindWeakLambda(
-		Actor.Get(),
-		[bDebugEnabled = bDebugEnabled, InstanceDataRef = Context.GetInstanceDataStructRef(*this), &EventQueue, Owner = Context.GetOwner(), MsgPart](FGameplayEventData Payload)
-		{
-			if (FInstanceDataType* InstanceData = InstanceDataRef.GetPtr())
-			{
-				CTRLST_CLOG(bDebugEnabled, Warning, TEXT("Received gameplay event %s %s"), *Payload.EventTag.ToString(), *MsgPart);
-				if (InstanceData->bOnlyTriggerOnce)
-				{
-					InstanceData->Bridge->EventReceived.Unbind();
-					InstanceData->Bridge->RemoveFromRoot();
-					InstanceData->Bridge = nullptr;
-				}
-				FStructView const StructView = FStructView::Make(Payload.TargetData);
-				EventQueue.SendEvent(Owner, Payload.EventTag, StructView);
-			}
-		}
-	);
-	return Bridge;
-}
-
 EStateTreeRunStatus FCTRLGasEventToStateTreeEventTask::EnterState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
-	auto& Data = Context.GetInstanceData<FInstanceDataType>(*this);
-	Data.Bridge = MakeBridge(Context);
 	if (ListenForEvents(Context))
 	{
 		return EStateTreeRunStatus::Running;
@@ -115,82 +76,77 @@ bool FCTRLGasEventToStateTreeEventTask::ListenForEvents(FStateTreeExecutionConte
 {
 	UnlistenForEvents(Context);
 	auto& Data = Context.GetInstanceData<FInstanceDataType>(*this);
-	auto& [Actor, EventTags, bOnlyMatchExact, bOnlyTriggerOnce, Bridge, DelegateHandles] = Data;
-	if (!Actor.IsValid()) return false;
-	if (UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor.Get()))
-	{
-		if (Data.bOnlyMatchExact)
-		{
-			for (auto const& EventTag : EventTags)
-			{
-				if (!EventTag.IsValid()) continue;
-				auto const DelegateHandle = ASC->GenericGameplayEventCallbacks.FindOrAdd(EventTag).AddUObject(Bridge, &UCTRLStateTreeEventBridge::GameplayEventCallback);
-				if (DelegateHandle.IsValid())
-				{
-					DelegateHandles.Add(DelegateHandle);
-				}
-			}
-		}
-		else
+	if (!Data.Actor.IsValid()) return false;
+	UAbilitySystemComponent* ASC = UCTRLAbilitySystemCacheSubsystem::FindAbilitySystem(Data.Actor.Get());
+	if (!ASC) return false;
+	Data.AbilitySystem = ASC;
+
+	FStateTreeEventQueue& EventQueue = Context.GetMutableEventQueue();
+	FString MsgPart = FString::Printf(TEXT("%s. Sending → StateTree %s"), *GetNameSafe(Data.Actor.Get()), *GetNameSafe(Context.GetStateTree()));
+	FCTRLGameplayEventDelegate OnEvent = FCTRLGameplayEventDelegate::CreateWeakLambda(
+		Data.Actor.Get(),
+		[bDebugEnabled = bDebugEnabled, InstanceDataRef = Context.GetInstanceDataStructRef(*this), &EventQueue, Owner = Context.GetOwner(), MsgPart = MoveTemp(MsgPart)](FGameplayTag const EventTag, FGameplayEventData const& Payload)
 		{
-			auto const DelegateHandle = ASC->AddGameplayEventTagContainerDelegate(
-				EventTags,
-				FGameplayEventTagMulticastDelegate::FDelegate::CreateUObject(Bridge, &UCTRLStateTreeEventBridge::GameplayEventContainerCallback)
-			);
-			if (DelegateHandle.IsValid())
+			FInstanceDataType const* InstanceData = InstanceDataRef.GetPtr();
+			if (!InstanceData) { return; }
+			CTRLST_CLOG(bDebugEnabled, Warning, TEXT("Received gameplay event %s %s"), *EventTag.ToString(), *MsgPart);
+			if (EventQueue.GetEventsView().Num() >= CTRL::GasEventToStateTreeEvent::Private::GetMaxQueuedEvents(InstanceData->Priority))
 			{
-				DelegateHandles.Add(DelegateHandle);
+				INC_DWORD_STAT(STAT_CTRLStateTree_DroppedGameplayEvents);
+				CTRLST_CLOG(bDebugEnabled, Warning, TEXT("Dropped gameplay event %s, StateTree event queue is full for its priority %s"), *EventTag.ToString(), *MsgPart);
+				UCTRLPawnStateTreeComponent::WakeUpStateTrees(Owner);
+				return;
 			}
+			// the payload is copied once, into the queued event
+			EventQueue.SendEvent(Owner, EventTag, InstanceData->bSendFullPayload ? FConstStructView::Make(Payload) : FConstStructView::Make(Payload.TargetData));
+			UCTRLPawnStateTreeComponent::WakeUpStateTrees(Owner);
 		}
+	);
+
+	if (auto const Router = UCTRLStateTreeEventRouterSubsystem::Get(Context.GetWorld()))
+	{
+		Data.Subscription = Router->Subscribe(*ASC, Data.EventTags, Data.bOnlyMatchExact, Data.bOnlyTriggerOnce, MoveTemp(OnEvent), Data.Coalescing);
 		return true;
 	}
-	return false;
+
+	// the router only exists in game & PIE worlds, elsewhere listen on the ASC directly, without coalescing
+	Data.DelegateHandle = ASC->AddGameplayEventTagContainerDelegate(
+		FGameplayTagContainer(),
+		FGameplayEventTagMulticastDelegate::FDelegate::CreateWeakLambda(
+			Data.Actor.Get(),
+			[InstanceDataRef = Context.GetInstanceDataStructRef(*this), EventTags = Data.EventTags, bOnlyMatchExact = Data.bOnlyMatchExact, OnEvent = MoveTemp(OnEvent)](FGameplayTag const EventTag, FGameplayEventData const* Payload)
+			{
+				if (!Payload) { return; }
+				if (bOnlyMatchExact ? !EventTags.HasTagExact(EventTag) : !EventTag.MatchesAny(EventTags)) { return; }
+				OnEvent.ExecuteIfBound(EventTag, *Payload);
+				FInstanceDataType* InstanceData = InstanceDataRef.GetPtr();
+				if (InstanceData && InstanceData->bOnlyTriggerOnce)
+				{
+					// the ASC broadcasts a copy of its delegates, removing ours while it runs is safe
+					CTRL::GasEventToStateTreeEvent::Private::RemoveDelegate(*InstanceData);
+				}
+			}
+		)
+	);
+	return true;
 }
 
 void FCTRLGasEventToStateTreeEventTask::UnlistenForEvents(FStateTreeExecutionContext const& Context) const
 {
 	auto& Data = Context.GetInstanceData<FInstanceDataType>(*this);
-	auto& [Actor, EventTags, bOnlyMatchExact, bOnlyTriggerOnce, Bridge, DelegateHandles] = Data;
-	if (Actor.IsValid())
+	CTRL::GasEventToStateTreeEvent::Private::RemoveDelegate(Data);
+	Data.AbilitySystem = nullptr;
+	if (!Data.Subscription.IsValid()) return;
+	if (auto const Router = UCTRLStateTreeEventRouterSubsystem::Get(Context.GetWorld()))
 	{
-		if (UAbilitySystemComponent* ASC = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor.Get()))
-		{
-			if (Data.bOnlyMatchExact)
-			{
-				for (auto const& EventTag : EventTags)
-				{
-					for (auto const& DelegateHandle : DelegateHandles)
-					{
-						if (!DelegateHandle.IsValid()) continue;
-						if (ASC->GenericGameplayEventCallbacks.Contains(EventTag))
-						{
-							ASC->GenericGameplayEventCallbacks.FindRef(EventTag).Remove(DelegateHandle);
-						}
-					}
-				}
-			}
-			else
-			{
-				for (auto const& DelegateHandle : DelegateHandles)
-				{
-					if (!DelegateHandle.IsValid()) continue;
-					ASC->RemoveGameplayEventTagContainerDelegate(EventTags, DelegateHandle);
-				}
-			}
-		}
+		Router->Unsubscribe(Data.Subscription);
 	}
-	DelegateHandles.Reset();
+	Data.Subscription = FCTRLGameplayEventSubscription();
 }
 
 void FCTRLGasEventToStateTreeEventTask::ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
 	UnlistenForEvents(Context);
-	auto& Data = Context.GetInstanceData<FInstanceDataType>(*this);
-	if (auto const Bridge = Data.Bridge)
-	{
-		Bridge->EventReceived.Unbind();
-		Data.Bridge = nullptr;
-	}
 }
 #if WITH_EDITOR
 FText FCTRLGasEventToStateTreeEventTask::GetDescription(
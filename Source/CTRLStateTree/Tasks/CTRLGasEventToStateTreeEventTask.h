@@ -9,23 +9,20 @@
 #include "Abilities/GameplayAbilityTypes.h"
 
 #include "CTRLStateTree/Tasks/CTRLStateTreeCommonBaseTask.h"
-
-#include "UObject/Object.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeEventRouterSubsystem.h"
 
 #include "CTRLGasEventToStateTreeEventTask.generated.h"
 
-// Task needs a UObject to be able to bind to ASC dynamic multicast delegates
-UCLASS(Hidden)
-class CTRLSTATETREE_API UCTRLStateTreeEventBridge : public UObject
+// Which events are dropped first when the StateTree event queue fills up
+UENUM(BlueprintType)
+enum class ECTRLGasEventPriority : uint8
 {
-	GENERATED_BODY()
-
-public:
-	void GameplayEventCallback(FGameplayEventData const* GameplayEventData) const;
-	void GameplayEventContainerCallback(FGameplayTag GameplayTag, FGameplayEventData const* GameplayEventData) const;
-
-	DECLARE_DELEGATE_OneParam(FGameplayEventReceivedDelegate, FGameplayEventData);
-	FGameplayEventReceivedDelegate EventReceived;
+	// Dropped once the event queue is half full
+	Low,
+	// Dropped when the event queue has only a few slots left, leaving those to high priority events
+	Normal,
+	// Only dropped when the event queue is full
+	High,
 };
 
 USTRUCT(BlueprintType, meta=(Hidden, Category="Internal"))
@@ -45,10 +42,23 @@ struct FCTRLGasEventToStateTreeEventTaskData
 	UPROPERTY(BlueprintReadOnly, EditAnywhere)
 	bool bOnlyTriggerOnce = false;
 
-	UPROPERTY(Transient)
-	TObjectPtr<UCTRLStateTreeEventBridge> Bridge = nullptr;
+	// Send the whole FGameplayEventData as the StateTree event payload, instead of only its TargetData
+	UPROPERTY(BlueprintReadOnly, EditAnywhere)
+	bool bSendFullPayload = false;
+
+	// Collapse bursts of the same event tag (e.g. damage ticks) into one StateTree event per frame
+	UPROPERTY(BlueprintReadOnly, EditAnywhere)
+	ECTRLGameplayEventCoalescing Coalescing = ECTRLGameplayEventCoalescing::None;
 
-	TArray<FDelegateHandle> BridgeDelegateHandles;
+	UPROPERTY(BlueprintReadOnly, EditAnywhere)
+	ECTRLGasEventPriority Priority = ECTRLGasEventPriority::Normal;
+
+	// see UCTRLStateTreeEventRouterSubsystem
+	FCTRLGameplayEventSubscription Subscription;
+	// Delegate on AbilitySystem, in worlds without the router (editor & preview worlds)
+	FDelegateHandle DelegateHandle;
+	// ASC of Actor, resolved on state enter
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
 };
 
 /*
@@ -69,9 +79,6 @@ public:
 	virtual void ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const override;
 	virtual EDataValidationResult Compile(FStateTreeDataView InstanceDataView, TArray<FText>& ValidationMessages) override;
 
-protected:
-	UCTRLStateTreeEventBridge* MakeBridge(FStateTreeExecutionContext const& Context) const;
-
 public:
 #if WITH_EDITOR
 	virtual FText GetDescription(
@@ -3,22 +3,21 @@
 
 #include "CTRLGasTriggerEventTask.h"
 
-#include "AbilitySystemBlueprintLibrary.h"
 #include "AbilitySystemComponent.h"
-#include "AbilitySystemGlobals.h"
 #include "StateTreeExecutionContext.h"
 
 #include "CTRLStateTree/CTRLStateTree.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
+#include "CTRLStateTree/Utils/CTRLAbilitySystemCacheSubsystem.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLGasTriggerEventTask)
 
 EStateTreeRunStatus FCTRLGasTriggerEventTask::EnterState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
-	auto const Data = Context.GetInstanceData<FCTRLGasTriggerEventTaskData>(*this);
+	auto& Data = Context.GetInstanceData<FCTRLGasTriggerEventTaskData>(*this);
 	if (Data.bUseEnterGameplayEvent)
 	{
-		bool const bSent = SendGameplayEvent(Data.EnterGameplayEvent, Data.TargetActors);
+		bool const bSent = SendGameplayEvent(Data.EnterGameplayEvent, Data);
 		if (!bSent && Data.bFailIfNotSent)
 		{
 			return EStateTreeRunStatus::Failed;
@@ -29,15 +28,22 @@ EStateTreeRunStatus FCTRLGasTriggerEventTask::EnterState(FStateTreeExecutionCont
 
 void FCTRLGasTriggerEventTask::ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
-	auto const Data = Context.GetInstanceData<FCTRLGasTriggerEventTaskData>(*this);
+	auto& Data = Context.GetInstanceData<FCTRLGasTriggerEventTaskData>(*this);
 	if (Data.bUseExitGameplayEvent)
 	{
 		// ReSharper disable once CppExpressionWithoutSideEffects
-		SendGameplayEvent(Data.ExitGameplayEvent, Data.TargetActors);
+		SendGameplayEvent(Data.ExitGameplayEvent, Data);
 	}
 }
 
-bool FCTRLGasTriggerEventTask::SendGameplayEvent(FGameplayEventData const& EventData, TArray<AActor*> const& TargetActors) const
+void FCTRLGasTriggerEventTask::SendGameplayEventToAbilitySystem(UAbilitySystemComponent& AbilitySystem, FGameplayEventData const& EventData)
+{
+	// same as UAbilitySystemBlueprintLibrary::SendGameplayEventToActor, without resolving the ASC again
+	FScopedPredictionWindow NewScopedWindow(&AbilitySystem, true);
+	AbilitySystem.HandleGameplayEvent(EventData.EventTag, &EventData);
+}
+
+bool FCTRLGasTriggerEventTask::SendGameplayEvent(FGameplayEventData const& EventData, FInstanceDataType const& Data) const
 {
 	if (EventData.Target)
 	{
@@ -49,23 +55,28 @@ bool FCTRLGasTriggerEventTask::SendGameplayEvent(FGameplayEventData const& Event
 			CTRLST_LOG(Warning, TEXT("Invalid Target Actor"));
 			return false;
 		}
-		if (!IsValid(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Target)))
+		UAbilitySystemComponent* AbilitySystem = UCTRLAbilitySystemCacheSubsystem::FindAbilitySystem(Target);
+		if (!IsValid(AbilitySystem))
 		{
 			CTRLST_LOG(Warning, TEXT("Target Actor has no ASC %s"), *GetNameSafe(Target));
 			return false;
 		}
-		UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(const_cast<AActor*>(Target), EventData.EventTag, EventData);
+		SendGameplayEventToAbilitySystem(*AbilitySystem, EventData);
 		return true;
 	}
-	auto ValidActors = TargetActors.FilterByPredicate([](AActor const* Actor) { return IsValid(Actor) && IsValid(UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor)); });
 
-	CTRLST_CLOG(bDebugEnabled, Log, TEXT("Sending Gameplay Event %s to %d Actors"), *EventData.EventTag.ToString(), ValidActors.Num());
-	for (auto const Actor : ValidActors)
+	CTRLST_CLOG(bDebugEnabled, Log, TEXT("Sending Gameplay Event %s to %d Actors"), *EventData.EventTag.ToString(), Data.TargetActors.Num());
+	int32 NumSent = 0;
+	for (AActor const* Actor : Data.TargetActors)
 	{
+		// resolved on every send, the cache checks the ASC still has Actor as owner or avatar
+		UAbilitySystemComponent* AbilitySystem = UCTRLAbilitySystemCacheSubsystem::FindAbilitySystem(Actor);
+		if (!IsValid(AbilitySystem)) { continue; }
 		CTRLST_CLOG(bDebugEnabled, Log, TEXT("\tSending Gameplay Event %s to %s"), *EventData.EventTag.ToString(), *Actor->GetName());
-		UAbilitySystemBlueprintLibrary::SendGameplayEventToActor(Actor, EventData.EventTag, EventData);
+		SendGameplayEventToAbilitySystem(*AbilitySystem, EventData);
+		++NumSent;
 	}
-	return ValidActors.Num() > 0;
+	return NumSent > 0;
 }
 
 #if WITH_EDITOR
@@ -63,5 +63,6 @@ public:
 #endif
 
 protected:
-	[[maybe_unused]] bool SendGameplayEvent(FGameplayEventData const& EventData, TArray<AActor*> const& TargetActors) const;
+	[[maybe_unused]] bool SendGameplayEvent(FGameplayEventData const& EventData, FInstanceDataType const& Data) const;
+	static void SendGameplayEventToAbilitySystem(UAbilitySystemComponent& AbilitySystem, FGameplayEventData const& EventData);
 };
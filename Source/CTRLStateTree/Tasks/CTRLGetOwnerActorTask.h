@@ -25,7 +25,7 @@ struct FCTRLGetOwnerActorData
 	bool bIsValid = false;
 };
 
-USTRUCT(BlueprintType, DisplayName="Get Owner Actor [CTRL]", meta=(Category="Actor"))
+USTRUCT(BlueprintType, DisplayName="Get Owner Actor [CTRL]", meta=(Category="Actor", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLGetOwnerActorTask : public FCTRLStateTreeCommonBaseTask
 {
 	GENERATED_BODY()
@@ -6,6 +6,7 @@
 #include "PropertyHandle.h"
 #include "StateTreeExecutionContext.h"
 
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
 
 #include "Engine/World.h"
@@ -43,7 +44,12 @@ void FCTRLPrintTextTask::Print(FStateTreeExecutionContext& Context, FCTRLPrintTe
 		Prefix = Prefix.Append(Context.GetActiveStateName());
 	}
 	Prefix = Prefix.Append(": ");
-	UKismetSystemLibrary::PrintString(Context.GetWorld(), Prefix + Config.Message.ToString(), Config.bPrintToScreen, Config.bPrintToLog, Config.TextColor, Config.Duration);
+	CTRL::StateTree::RunOnGameThread(
+		[WeakWorld = MakeWeakObjectPtr(Context.GetWorld()), Message = Prefix + Config.Message.ToString(), Config]()
+		{
+			UKismetSystemLibrary::PrintString(WeakWorld.Get(), Message, Config.bPrintToScreen, Config.bPrintToLog, Config.TextColor, Config.Duration);
+		}
+	);
 }
 
 #if WITH_EDITOR
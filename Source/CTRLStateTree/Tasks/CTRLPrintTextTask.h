@@ -57,7 +57,7 @@ struct FCTRLPrintTextTaskData
 	FCTRLPrintTextTaskOnEventConfig OnExit;
 };
 
-USTRUCT(BlueprintType, DisplayName="Print Text [CTRL]", meta=(Category="Debug"))
+USTRUCT(BlueprintType, DisplayName="Print Text [CTRL]", meta=(Category="Debug", CTRLThreadSafe))
 struct CTRLSTATETREE_API FCTRLPrintTextTask : public FCTRLStateTreeCommonBaseTask
 {
 	GENERATED_BODY()
@@ -18,16 +18,32 @@ EStateTreeRunStatus FCTRLSetCharacterGravityTask::EnterState(FStateTreeExecution
 	if (!InstanceData.Character) { return EStateTreeRunStatus::Failed; }
 	InstanceData.PreviousGravityScale = InstanceData.Character->GetCharacterMovement()->GravityScale;
 	InstanceData.Character->GetCharacterMovement()->GravityScale = InstanceData.TargetGravityScale;
+	InstanceData.AppliedCharacter = InstanceData.Character;
 	return EStateTreeRunStatus::Running;
 }
 
+void FCTRLSetCharacterGravityTask::OnContextChanged(FStateTreeExecutionContext& Context) const
+{
+	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (InstanceData.Character == InstanceData.AppliedCharacter) { return; }
+	if (InstanceData.bRevertOnExit && IsValid(InstanceData.AppliedCharacter))
+	{
+		InstanceData.AppliedCharacter->GetCharacterMovement()->GravityScale = InstanceData.PreviousGravityScale;
+	}
+	InstanceData.AppliedCharacter = InstanceData.Character;
+	if (!InstanceData.Character) { return; }
+	InstanceData.PreviousGravityScale = InstanceData.Character->GetCharacterMovement()->GravityScale;
+	InstanceData.Character->GetCharacterMovement()->GravityScale = InstanceData.TargetGravityScale;
+}
+
 void FCTRLSetCharacterGravityTask::ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
-	if (InstanceData.bRevertOnExit)
+	if (InstanceData.bRevertOnExit && IsValid(InstanceData.AppliedCharacter))
 	{
-		InstanceData.Character->GetCharacterMovement()->GravityScale = InstanceData.PreviousGravityScale;
+		InstanceData.AppliedCharacter->GetCharacterMovement()->GravityScale = InstanceData.PreviousGravityScale;
 	}
+	InstanceData.AppliedCharacter = nullptr;
 }
 
 #if WITH_EDITOR
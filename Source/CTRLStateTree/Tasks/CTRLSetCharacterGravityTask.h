@@ -31,6 +31,10 @@ struct FCTRLSetActorGravityData
 	// stored gravity scale before entering the state
 	UPROPERTY(BlueprintReadWrite, Transient)
 	float PreviousGravityScale = 1.0f;
+
+	// character the gravity scale was applied to, to move it over when the pawn is rebound
+	UPROPERTY(Transient)
+	TObjectPtr<ACharacter> AppliedCharacter = nullptr;
 };
 
 USTRUCT(BlueprintType, DisplayName="Set Character Gravity Scale [CTRL]", meta=(Category="Actor"))
@@ -39,10 +43,17 @@ struct CTRLSTATETREE_API FCTRLSetCharacterGravityTask : public FCTRLStateTreeCom
 	GENERATED_BODY()
 
 public:
+	FCTRLSetCharacterGravityTask()
+	{
+		// follows the pawn on rebind
+		bShouldCallTickOnlyOnEvents = true;
+	}
+
 	using FInstanceDataType = FCTRLSetActorGravityData;
 	virtual UStruct const* GetInstanceDataType() const override { return FInstanceDataType::StaticStruct(); }
 	virtual EStateTreeRunStatus EnterState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const override;
 	virtual void ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const override;
+	virtual void OnContextChanged(FStateTreeExecutionContext& Context) const override;
 
 #if WITH_EDITOR
 	virtual FText GetDescription(
@@ -5,16 +5,91 @@
 
 #include "StateTreeExecutionContext.h"
 
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
 #include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
 #include "CTRLStateTree/CTRLStateTreeUtils.h"
 
 #include "Engine/World.h"
 
 #include "Kismet/KismetMathLibrary.h"
 
+namespace CTRL::SpawnActorTask::Private
+{
+	AActor* Spawn(UWorld* World, FCTRLSpawnActorData const& InstanceData)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.Owner = InstanceData.Owner;
+		SpawnParameters.Instigator = InstanceData.Instigator;
+		SpawnParameters.SpawnCollisionHandlingOverride = InstanceData.CollisionHandlingMethod;
+		FTransform Transform = FTransform(InstanceData.SpawnRotation, InstanceData.SpawnLocation, InstanceData.SpawnScale);
+		auto Rotation = Transform.Rotator();
+		Rotation.Yaw += UKismetMathLibrary::RandomIntegerInRange(-InstanceData.RandomYaw * 0.5, InstanceData.RandomYaw * 0.5);
+		Transform.SetRotation(Rotation.Quaternion());
+		auto SpawnedActor = World->SpawnActor(InstanceData.ActorClass, &Transform, SpawnParameters);
+		if (!SpawnedActor)
+		{
+			CTRLST_LOG(Error, TEXT("Failed to spawn actor: %s"), *InstanceData.ActorClass.Get()->GetDisplayNameText().ToString())
+		}
+		return SpawnedActor;
+	}
+
+	void DestroySpawnedActor(FCTRLSpawnActorData& InstanceData)
+	{
+		if (InstanceData.bDestroyOnExit && IsValid(InstanceData.SpawnedActor))
+		{
+			auto const SpawnedActor = InstanceData.SpawnedActor;
+			InstanceData.SpawnedActor = nullptr;
+			SpawnedActor->Destroy();
+		}
+	}
+}
+
 EStateTreeRunStatus FCTRLSpawnActorTask::EnterState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
+	using namespace CTRL::SpawnActorTask::Private;
 	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
+	if (CTRL::StateTree::IsInParallelTick())
+	{
+		// parallel tick, the world and the spawned actor are only touched on the game thread.
+		// The output is filled in there, a failed spawn finishes the task on the next tick
+		CTRL::StateTree::RunOnGameThread(
+			[
+				WeakOwner = MakeWeakObjectPtr(Context.GetOwner()),
+				WeakContext = Context.MakeWeakExecutionContext(),
+				InstanceDataRef = Context.GetInstanceDataStructRef(*this),
+				SpawnData = InstanceData
+			]()
+			{
+				UObject* Owner = WeakOwner.Get();
+				FInstanceDataType* Data = InstanceDataRef.GetPtr();
+				if (!Owner || !Data) { return; }
+				if (Data->SpawnedActor) { return; }
+				AActor* SpawnedActor = nullptr;
+				if (!SpawnData.ActorClass)
+				{
+					CTRLST_LOG(Error, TEXT("Failed to spawn actor: No Actor Class."));
+				}
+				else if (UWorld* World = Owner->GetWorld())
+				{
+					SpawnedActor = Spawn(World, SpawnData);
+				}
+				else
+				{
+					CTRLST_LOG(Error, TEXT("Failed to spawn actor: No World."));
+				}
+				if (!SpawnedActor)
+				{
+					WeakContext.FinishTask(EStateTreeFinishTaskType::Failed);
+					UCTRLPawnStateTreeComponent::WakeUpStateTrees(Owner);
+					return;
+				}
+				Data->SpawnedActor = SpawnedActor;
+			}
+		);
+		return EStateTreeRunStatus::Running;
+	}
+
 	if (InstanceData.SpawnedActor)
 	{
 		return EStateTreeRunStatus::Running;
@@ -30,18 +105,10 @@ EStateTreeRunStatus FCTRLSpawnActorTask::EnterState(FStateTreeExecutionContext&
 		CTRLST_LOG(Error, TEXT("Failed to spawn actor: No World."));
 		return EStateTreeRunStatus::Failed;
 	}
-	FActorSpawnParameters SpawnParameters;
-	SpawnParameters.Owner = InstanceData.Owner;
-	SpawnParameters.Instigator = InstanceData.Instigator;
-	SpawnParameters.SpawnCollisionHandlingOverride = InstanceData.CollisionHandlingMethod;
-	FTransform Transform = FTransform(InstanceData.SpawnRotation, InstanceData.SpawnLocation, InstanceData.SpawnScale);
-	auto Rotation = Transform.Rotator();
-	Rotation.Yaw += UKismetMathLibrary::RandomIntegerInRange(-InstanceData.RandomYaw * 0.5, InstanceData.RandomYaw * 0.5);
-	Transform.SetRotation(Rotation.Quaternion());
-	auto SpawnedActor = World->SpawnActor(InstanceData.ActorClass, &Transform, SpawnParameters);
+
+	auto SpawnedActor = Spawn(World, InstanceData);
 	if (!SpawnedActor)
 	{
-		CTRLST_LOG(Error, TEXT("Failed to spawn actor: %s"), *InstanceData.ActorClass.Get()->GetDisplayNameText().ToString())
 		return EStateTreeRunStatus::Failed;
 	}
 
@@ -51,13 +118,22 @@ EStateTreeRunStatus FCTRLSpawnActorTask::EnterState(FStateTreeExecutionContext&
 
 void FCTRLSpawnActorTask::ExitState(FStateTreeExecutionContext& Context, FStateTreeTransitionResult const& Transition) const
 {
-	FInstanceDataType& InstanceData = Context.GetInstanceData(*this);
-	if (InstanceData.bDestroyOnExit && IsValid(InstanceData.SpawnedActor))
+	using namespace CTRL::SpawnActorTask::Private;
+	if (CTRL::StateTree::IsInParallelTick())
 	{
-		auto const SpawnedActor = InstanceData.SpawnedActor;
-		InstanceData.SpawnedActor = nullptr;
-		SpawnedActor->Destroy();
+		// queued after a deferred spawn from EnterState, so SpawnedActor is set by the time this runs
+		CTRL::StateTree::RunOnGameThread(
+			[InstanceDataRef = Context.GetInstanceDataStructRef(*this)]()
+			{
+				if (FInstanceDataType* Data = InstanceDataRef.GetPtr())
+				{
+					DestroySpawnedActor(*Data);
+				}
+			}
+		);
+		return;
 	}
+	DestroySpawnedActor(Context.GetInstanceData(*this));
 }
 #if WITH_EDITOR
 FText FCTRLSpawnActorTask::GetDescription(FGuid const& ID, FStateTreeDataView const InstanceDataView, IStateTreeBindingLookup const& BindingLookup, EStateTreeNodeFormatting const Formatting) const
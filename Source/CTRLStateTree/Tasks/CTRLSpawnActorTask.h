@@ -52,6 +52,11 @@ struct FCTRLSpawnActorData
 	TObjectPtr<AActor> SpawnedActor = nullptr;
 };
 
+/**
+ * Spawns an actor on enter and optionally destroys it on exit.
+ * Game thread only, a tree using it ticks on the game thread. If a project lists it under Thread Safe Nodes anyway, the actor
+ * is spawned on the game thread after the parallel phase, so SpawnedActor is only valid from the next tick.
+ */
 USTRUCT(BlueprintType, DisplayName="Spawn Actor [CTRL]", meta=(Category="Actor"))
 struct CTRLSTATETREE_API FCTRLSpawnActorTask : public FCTRLStateTreeCommonBaseTask
 {
@@ -3,4 +3,21 @@
 
 #include "CTRLStateTreeCommonBaseTask.h"
 
+#include "StateTreeExecutionContext.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+
 #include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeCommonBaseTask)
+
+EStateTreeRunStatus FCTRLStateTreeCommonBaseTask::Tick(FStateTreeExecutionContext& Context, float const DeltaTime) const
+{
+	for (FStateTreeSharedEvent const& Event : Context.GetEventsToProcessView())
+	{
+		if (Event->Tag.MatchesTagExact(CTRL::PawnStateTree::Tags::Event_ContextChanged))
+		{
+			OnContextChanged(Context);
+			break;
+		}
+	}
+	return Super::Tick(Context, DeltaTime);
+}
@@ -26,6 +26,15 @@ struct FCTRLStateTreeCommonBaseTask : public FStateTreeTaskCommonBase
 	UPROPERTY(BlueprintReadWrite, EditAnywhere)
 	bool bDebugEnabled = false;
 
+	// Checks for the ContextChanged event, see UCTRLPawnStateTreeComponent::bRebindPawnOnPossessedPawnChanged.
+	// Only called with bShouldCallTick or bShouldCallTickOnlyOnEvents, so overrides must call Super.
+	virtual EStateTreeRunStatus Tick(FStateTreeExecutionContext& Context, float DeltaTime) const override;
+
+	// Called when the pawn state tree component swapped a context actor without restarting.
+	// Bound properties were already copied, so instance data holds the new values.
+	// To opt in, set bShouldCallTickOnlyOnEvents (or bShouldCallTick).
+	virtual void OnContextChanged(FStateTreeExecutionContext& Context) const {}
+
 #if WITH_EDITOR
 	virtual FColor GetIconColor() const override
 	{
@@ -0,0 +1,237 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTree/Utils/CTRLChangeInputConfigSubsystem.h"
+
+#include "Engine/Engine.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/World.h"
+
+#include "GameFramework/PlayerController.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CTRL::ChangeInputConfig::Tests::Private
+{
+	FCTRLInputModeConfig MakeCursorInputConfig(ECTRLMouseCursor const MouseCursor)
+	{
+		FCTRLInputModeConfig InputConfig;
+		InputConfig.InputMode = ECTRLInputMode::GameAndUI;
+		InputConfig.bOverrideInputModeDefault = true;
+		InputConfig.bOverrideMouseCursor = true;
+		InputConfig.MouseCursor = MouseCursor;
+		return InputConfig;
+	}
+
+	FCTRLInputModeConfig MakeIgnoreLookInputConfig()
+	{
+		FCTRLInputModeConfig InputConfig;
+		InputConfig.bOverrideInputModeDefault = true;
+		InputConfig.IgnoreInputConfig.bOverrideIgnoreLookInput = true;
+		InputConfig.IgnoreInputConfig.bIgnoreLookInput = true;
+		return InputConfig;
+	}
+
+	/*
+	 * Local player without a game viewport: a player controller in a transient game world and an uninitialized
+	 * viewport client, so pushes & pops are applied like in a headless game. The client has no viewport widget,
+	 * so the Slate focus, capture & cursor calls are skipped.
+	 */
+	struct FFakeLocalPlayer
+	{
+		FFakeLocalPlayer()
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("CTRLInputConfigTest"));
+			FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+			WorldContext.SetCurrentWorld(World);
+			World->InitializeActorsForPlay(FURL());
+			World->BeginPlay();
+
+			LocalPlayer = NewObject<ULocalPlayer>(GEngine);
+			LocalPlayer->ViewportClient = NewObject<UGameViewportClient>(GEngine);
+			PlayerController = World->SpawnActor<APlayerController>();
+			PlayerController->Player = LocalPlayer;
+			LocalPlayer->PlayerController = PlayerController;
+			Subsystem = NewObject<UCTRLChangeInputConfigSubsystem>(LocalPlayer);
+		}
+
+		~FFakeLocalPlayer()
+		{
+			Subsystem->Deinitialize();
+			Subsystem->MarkAsGarbage();
+			LocalPlayer->PlayerController = nullptr;
+			LocalPlayer->ViewportClient->MarkAsGarbage();
+			LocalPlayer->MarkAsGarbage();
+			GEngine->DestroyWorldContext(World);
+			World->DestroyWorld(false);
+		}
+
+		UE_NONCOPYABLE(FFakeLocalPlayer);
+
+		UWorld* World = nullptr;
+		ULocalPlayer* LocalPlayer = nullptr;
+		APlayerController* PlayerController = nullptr;
+		UCTRLChangeInputConfigSubsystem* Subsystem = nullptr;
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FCTRLPackedInputModeConfigTest,
+	"CTRL.InputConfig.PackedConfig",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FCTRLPackedInputModeConfigTest::RunTest(FString const& Parameters)
+{
+	using namespace CTRL::ChangeInputConfig::Tests::Private;
+
+	FCTRLInputModeConfig const CursorConfig = MakeCursorInputConfig(ECTRLMouseCursor::Crosshairs);
+	TestTrue(TEXT("Pack/Unpack round-trips"), FCTRLPackedInputModeConfig::Pack(CursorConfig).Unpack() == CursorConfig);
+
+	// a config that doesn't override the cursor keeps the one below it
+	FCTRLPackedInputModeConfig Folded = FCTRLPackedInputModeConfig::Pack(CursorConfig);
+	Folded.Fold(FCTRLPackedInputModeConfig::Pack(MakeIgnoreLookInputConfig()));
+	FCTRLInputModeConfig const FoldedConfig = Folded.Unpack();
+	TestEqual(TEXT("Fold keeps the cursor below"), FoldedConfig.MouseCursor, ECTRLMouseCursor::Crosshairs);
+	TestTrue(TEXT("Fold applies the overridden fields"), FoldedConfig.IgnoreLookInput());
+	TestEqual(TEXT("Fold always applies the input mode"), FoldedConfig.InputMode, ECTRLInputMode::GameOnly);
+
+	Folded.Fold(FCTRLPackedInputModeConfig::Pack(MakeCursorInputConfig(ECTRLMouseCursor::Hand)));
+	TestEqual(TEXT("Fold replaces an overridden cursor"), Folded.Unpack().MouseCursor, ECTRLMouseCursor::Hand);
+
+	FCTRLPackedInputModeConfig const Packed = FCTRLPackedInputModeConfig::Pack(CursorConfig);
+	TestEqual(TEXT("Diff of equal configs"), Packed.Diff(Packed), ECTRLInputConfigChange::None);
+
+	FCTRLInputModeConfig FlushConfig = CursorConfig;
+	FlushConfig.bFlushInput = !FlushConfig.bFlushInput;
+	TestEqual(TEXT("Diff ignores flush"), Packed.Diff(FCTRLPackedInputModeConfig::Pack(FlushConfig)), ECTRLInputConfigChange::None);
+	TestEqual(
+		TEXT("Diff of a cursor change"),
+		Packed.Diff(FCTRLPackedInputModeConfig::Pack(MakeCursorInputConfig(ECTRLMouseCursor::Hand))),
+		ECTRLInputConfigChange::MouseCursor
+	);
+
+	FCTRLInputModeConfig UIOnlyConfig = CursorConfig;
+	UIOnlyConfig.InputMode = ECTRLInputMode::UIOnly;
+	TestEqual(TEXT("Diff of an input mode change"), Packed.Diff(FCTRLPackedInputModeConfig::Pack(UIOnlyConfig)), ECTRLInputConfigChange::InputMode);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FCTRLChangeInputConfigStackTest,
+	"CTRL.InputConfig.Stack",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FCTRLChangeInputConfigStackTest::RunTest(FString const& Parameters)
+{
+	using namespace CTRL::ChangeInputConfig::Tests::Private;
+
+	FFakeLocalPlayer Player;
+	UCTRLChangeInputConfigSubsystem& Subsystem = *Player.Subsystem;
+	TestFalse(TEXT("Empty stack builds no config"), Subsystem.GetPackedInputConfigFromStack().IsSet());
+
+	FCTRLInputModeConfig const A = MakeCursorInputConfig(ECTRLMouseCursor::Crosshairs);
+	FCTRLInputModeConfig const B = MakeCursorInputConfig(ECTRLMouseCursor::Hand);
+	FCTRLInputModeConfig const C = MakeIgnoreLookInputConfig();
+	FCTRLInputConfigHandle HandleA;
+	FCTRLInputConfigHandle HandleB;
+	FCTRLInputConfigHandle HandleC;
+	{
+		FCTRLInputConfigBatchScope Batch(&Subsystem);
+		HandleA = Subsystem.PushInputConfigHandle(A);
+		HandleB = Subsystem.PushInputConfigHandle(B);
+		HandleC = Subsystem.PushInputConfigHandle(C);
+	}
+
+	FCTRLPackedInputModeConfig Expected = FCTRLPackedInputModeConfig::Pack(A);
+	Expected.Fold(FCTRLPackedInputModeConfig::Pack(B));
+	Expected.Fold(FCTRLPackedInputModeConfig::Pack(C));
+	TestTrue(TEXT("Stack of A, B, C"), Subsystem.GetPackedInputConfigFromStack() == Expected);
+	TestTrue(TEXT("Top is applied"), Subsystem.CurrentInputConfigHandle == HandleC);
+	TestTrue(TEXT("Applied config is the folded stack"), Subsystem.AppliedInputConfig == Expected);
+
+	// pop from the middle: C now inherits A's cursor
+	{
+		FCTRLInputConfigBatchScope Batch(&Subsystem);
+		Subsystem.PopInputConfig(HandleB);
+		Expected = FCTRLPackedInputModeConfig::Pack(A);
+		Expected.Fold(FCTRLPackedInputModeConfig::Pack(C));
+		TestTrue(TEXT("Popped config is skipped before the update"), Subsystem.GetPackedInputConfigFromStack() == Expected);
+	}
+	TestFalse(TEXT("Popped handle is invalid"), Subsystem.IsHandleValid(HandleB));
+	TestEqual(TEXT("Stale handle dropped on update"), Subsystem.InputConfigHandleStack.Num(), 2);
+	if (Subsystem.InputConfigHandleStack.Num() == 2)
+	{
+		TestTrue(TEXT("Order kept, bottom"), Subsystem.InputConfigHandleStack[0] == HandleA);
+		TestTrue(TEXT("Order kept, top"), Subsystem.InputConfigHandleStack[1] == HandleC);
+		TestEqual(TEXT("Stack index of A"), Subsystem.InputConfigSlots[HandleA.Index].StackIndex, 0);
+		TestEqual(TEXT("Stack index of C"), Subsystem.InputConfigSlots[HandleC.Index].StackIndex, 1);
+	}
+	TestTrue(TEXT("Stack of A, C"), Subsystem.GetPackedInputConfigFromStack() == Expected);
+	TestEqual(TEXT("Inherited cursor"), Subsystem.GetInputConfigFromStack().MouseCursor, ECTRLMouseCursor::Crosshairs);
+
+	// caller supplied guids are found through the fallback
+	FGuid const Guid = FGuid::NewGuid();
+	{
+		FCTRLInputConfigBatchScope Batch(&Subsystem);
+		Subsystem.PushInputConfig(B, Guid);
+	}
+	FCTRLInputConfigHandle const HandleFromGuid = Subsystem.FindHandle(Guid);
+	TestTrue(TEXT("Caller supplied guid found"), Subsystem.IsHandleValid(HandleFromGuid));
+	TestTrue(TEXT("Guid pushed on top"), Subsystem.PeekInputConfigStack() == HandleFromGuid);
+	{
+		FCTRLInputConfigBatchScope Batch(&Subsystem);
+		Subsystem.PopInputConfig(Guid);
+		Subsystem.PopInputConfig(HandleC);
+	}
+	TestTrue(TEXT("Only A left"), Subsystem.GetPackedInputConfigFromStack() == FCTRLPackedInputModeConfig::Pack(A));
+	TestTrue(TEXT("A applied"), Subsystem.CurrentInputConfigHandle == HandleA);
+	TestTrue(TEXT("Popped slot reused with a new generation"), Subsystem.PushInputConfigHandle(C) != HandleC);
+	return true;
+}
+
+/*
+ * Headless version of CTRL.InputConfig.Benchmark, on a fake local player. Measures the stack, the folding, the diff and
+ * the player controller setters only: there is no viewport widget, so the Slate calls are not measured (run the
+ * CTRL.InputConfig.Benchmark console command in a game for those).
+ * UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CTRL.InputConfig.Benchmark; Quit"
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FCTRLChangeInputConfigBenchmarkTest,
+	"CTRL.InputConfig.Benchmark",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+void FCTRLChangeInputConfigBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (int32 const NumConfigs : {10, 100, 1000})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%d"), NumConfigs));
+		OutTestCommands.Add(FString::Printf(TEXT("%d"), NumConfigs));
+	}
+}
+
+bool FCTRLChangeInputConfigBenchmarkTest::RunTest(FString const& Parameters)
+{
+	using namespace CTRL::ChangeInputConfig::Tests::Private;
+
+	int32 const NumConfigs = FCString::Atoi(*Parameters);
+	FFakeLocalPlayer Player;
+	CTRL::ChangeInputConfig::FBenchmarkResult const Result = CTRL::ChangeInputConfig::RunBenchmark(*Player.Subsystem, NumConfigs);
+	TestEqual(TEXT("Every push & pop ran"), Result.NumOperations, NumConfigs * 2);
+	TestTrue(TEXT("Stack is empty afterwards"), Player.Subsystem->InputConfigHandleStack.IsEmpty());
+	TestFalse(TEXT("Slate isn't reached headless"), Result.bMeasuredSlate);
+	AddInfo(FString::Printf(
+		TEXT("%d configs: %.3f us per op, %.2f setter calls per op, Slate calls not measured"),
+		NumConfigs,
+		Result.MicrosecondsPerOperation,
+		Result.SetterCallsPerOperation
+	));
+	return true;
+}
+
+#endif
@@ -0,0 +1,158 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTreeTimings.h"
+#include "CTRLStateTree/Tests/CTRLStateTreeTestUtils.h"
+
+#include "AIController.h"
+#include "StateTree.h"
+
+#include "Engine/World.h"
+
+#include "GameFramework/Pawn.h"
+
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace CTRL::StateTree::Tests::Private
+{
+	constexpr int32 NumTickedFrames = 60;
+	constexpr float FrameDeltaTime = 1.f / 30.f;
+
+	FVector GetBenchmarkPawnLocation(int32 const Index)
+	{
+		return FVector(100. * (Index % 100), 100. * (Index / 100), 0.);
+	}
+
+	// -CTRLStateTreeBenchmarkTree=/Game/Path/To.Tree, otherwise the sample tree built in code (editor only)
+	UStateTree* LoadBenchmarkStateTree()
+	{
+		FString StateTreePath;
+		if (FParse::Value(FCommandLine::Get(), TEXT("CTRLStateTreeBenchmarkTree="), StateTreePath))
+		{
+			return LoadObject<UStateTree>(nullptr, *StateTreePath);
+		}
+#if WITH_EDITOR
+		return BuildSampleStateTree();
+#else
+		return nullptr;
+#endif
+	}
+
+	void SpawnPawns(UWorld& World, UStateTree* StateTree, int32 const NumPawns, TArray<UCTRLPawnStateTreeComponent*>& OutComponents)
+	{
+		OutComponents.Reserve(NumPawns);
+		for (int32 Index = 0; Index < NumPawns; ++Index)
+		{
+			if (auto const Component = SpawnPawnWithStateTree(World, StateTree, GetBenchmarkPawnLocation(Index), true))
+			{
+				OutComponents.Add(Component);
+			}
+		}
+	}
+
+	// New pawn per controller, spawned up front so only the possession & the restart it triggers are timed
+	double RepossessPawns(UWorld& World, TArray<UCTRLPawnStateTreeComponent*> const& Components)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		TArray<APawn*> NewPawns;
+		NewPawns.Reserve(Components.Num());
+		for (int32 Index = 0; Index < Components.Num(); ++Index)
+		{
+			NewPawns.Add(World.SpawnActor<APawn>(GetBenchmarkPawnLocation(Index) + FVector(0., 0., 200.), FRotator::ZeroRotator, SpawnParameters));
+		}
+
+		double const StartTime = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Components.Num(); ++Index)
+		{
+			auto const Controller = Cast<AController>(Components[Index]->GetOwner());
+			if (!Controller || !NewPawns[Index]) { continue; }
+			// bRestartLogicOnPossessedPawnChanged is on by default & not coalesced, the restart happens in Possess
+			Controller->Possess(NewPawns[Index]);
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+
+	double StopPawns(TArray<UCTRLPawnStateTreeComponent*> const& Components)
+	{
+		double const StartTime = FPlatformTime::Seconds();
+		for (UCTRLPawnStateTreeComponent* Component : Components)
+		{
+			Component->StopLogic(TEXT("Benchmark"));
+		}
+		return FPlatformTime::Seconds() - StartTime;
+	}
+}
+
+/*
+ * Spawns 100, 1k and 10k pawns with AI controllers and pawn state tree components, then times four phases: spawn & start,
+ * ticking the world, every controller possessing a new pawn (restarting its tree) and StopLogic. Writes the per call
+ * timings (see CTRL.StateTree.DumpTimings) to Saved/Profiling/CTRLStateTree.
+ * Headless: UnrealEditor-Cmd <Project> -nullrhi -unattended -ExecCmds="Automation RunTests CTRL.StateTree.Benchmark; Quit"
+ * [-CTRLStateTreeBenchmarkTree=/Game/Path/To.Tree], the sample tree from BuildSampleStateTree is used without it.
+ */
+IMPLEMENT_COMPLEX_AUTOMATION_TEST(
+	FCTRLPawnStateTreeBenchmarkTest,
+	"CTRL.StateTree.Benchmark.Pawns",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::PerfFilter
+)
+
+void FCTRLPawnStateTreeBenchmarkTest::GetTests(TArray<FString>& OutBeautifiedNames, TArray<FString>& OutTestCommands) const
+{
+	for (int32 const NumPawns : {100, 1000, 10000})
+	{
+		OutBeautifiedNames.Add(FString::Printf(TEXT("%d"), NumPawns));
+		OutTestCommands.Add(FString::Printf(TEXT("%d"), NumPawns));
+	}
+}
+
+bool FCTRLPawnStateTreeBenchmarkTest::RunTest(FString const& Parameters)
+{
+	using namespace CTRL::StateTree;
+	using namespace CTRL::StateTree::Tests;
+	using namespace CTRL::StateTree::Tests::Private;
+
+	int32 const NumPawns = FCString::Atoi(*Parameters);
+	UStateTree* StateTree = LoadBenchmarkStateTree();
+	if (!StateTree)
+	{
+		AddWarning(TEXT("No StateTree to run, measuring the component overhead only. Pass -CTRLStateTreeBenchmarkTree outside of the editor"));
+	}
+
+	bool const bWasRecording = Timings::IsRecording();
+	Timings::ResetSamples();
+	Timings::SetRecording(true);
+
+	UWorld* World = CreateTestWorld(TEXT("CTRLStateTreeBenchmark"));
+	TArray<UCTRLPawnStateTreeComponent*> Components;
+	double const SpawnStartTime = FPlatformTime::Seconds();
+	SpawnPawns(*World, StateTree, NumPawns, Components);
+	double const SpawnSeconds = FPlatformTime::Seconds() - SpawnStartTime;
+
+	double const TickStartTime = FPlatformTime::Seconds();
+	for (int32 Frame = 0; Frame < NumTickedFrames; ++Frame)
+	{
+		World->Tick(LEVELTICK_All, FrameDeltaTime);
+	}
+	double const TickSeconds = FPlatformTime::Seconds() - TickStartTime;
+
+	double const RepossessSeconds = RepossessPawns(*World, Components);
+	double const StopSeconds = StopPawns(Components);
+
+	DestroyTestWorld(World);
+	Timings::SetRecording(bWasRecording);
+
+	AddInfo(FString::Printf(TEXT("%d pawns: spawn & start %.2f ms, %.3f ms per frame, re-possess %.2f ms, stop %.2f ms"),
+		NumPawns, SpawnSeconds * 1000., TickSeconds * 1000. / NumTickedFrames, RepossessSeconds * 1000., StopSeconds * 1000.));
+	FString const FilePath = FPaths::ProfilingDir() / TEXT("CTRLStateTree") / FString::Printf(TEXT("Benchmark-%d-%s.csv"), NumPawns, *FDateTime::Now().ToString());
+	TestTrue(TEXT("Timings written"), Timings::WriteSamplesCsv(FilePath));
+	return true;
+}
+
+#endif
@@ -0,0 +1,79 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+#include "CTRLStateTree/Tests/CTRLStateTreeTestUtils.h"
+#include "CTRLStateTree/Utils/CTRLStateTreeInstanceDataPoolSubsystem.h"
+
+#include "StateTree.h"
+#include "StateTreeInstanceData.h"
+
+#include "Engine/World.h"
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS && WITH_EDITOR
+
+namespace CTRL::StateTree::Tests::Private
+{
+	// First instance struct of the running tree, its address tells whether the storage allocation was reused
+	void const* GetInstanceMemory(UCTRLPawnStateTreeComponent const& Component)
+	{
+		FStateTreeInstanceStorage const& Storage = Component.GetStateTreeInstanceData().GetStorage();
+		return Storage.Num() > 0 ? Storage.GetStruct(0).GetMemory() : nullptr;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FCTRLStateTreeInstanceDataPoolTest,
+	"CTRL.StateTree.InstanceDataPool",
+	EAutomationTestFlags_ApplicationContextMask | EAutomationTestFlags::EngineFilter
+)
+
+bool FCTRLStateTreeInstanceDataPoolTest::RunTest(FString const& Parameters)
+{
+	using namespace CTRL::StateTree::Tests;
+	using namespace CTRL::StateTree::Tests::Private;
+
+	UStateTree* StateTree = BuildSampleStateTree();
+	if (!TestNotNull(TEXT("Sample StateTree compiled"), StateTree)) { return false; }
+
+	UCTRLStateTreeSettings* Settings = GetMutableDefault<UCTRLStateTreeSettings>();
+	TGuardValue<int32> PoolSizeGuard(Settings->InstanceDataPoolSize, 4);
+
+	UWorld* World = CreateTestWorld(TEXT("CTRLInstanceDataPoolTest"));
+	ON_SCOPE_EXIT
+	{
+		DestroyTestWorld(World);
+	};
+	auto const PoolSubsystem = World->GetSubsystem<UCTRLStateTreeInstanceDataPoolSubsystem>();
+	if (!TestNotNull(TEXT("Pool subsystem"), PoolSubsystem)) { return false; }
+
+	UCTRLPawnStateTreeComponent* First = SpawnPawnWithStateTree(*World, StateTree, FVector::ZeroVector, false);
+	if (!TestTrue(TEXT("First tree running"), First && First->IsRunning())) { return false; }
+	World->Tick(LEVELTICK_All, 1.f / 30.f);
+	void const* FirstMemory = GetInstanceMemory(*First);
+	TestNotNull(TEXT("First tree has instance data"), FirstMemory);
+
+	// a restart of the same component runs on the storage it released
+	First->StopLogic(TEXT("Pool test"));
+	First->StartLogic();
+	TestTrue(TEXT("Restart reuses the allocation"), GetInstanceMemory(*First) == FirstMemory);
+
+	// a stopped tree's storage goes to the next start of the same asset, e.g. a respawn
+	First->StopLogic(TEXT("Pool test"));
+	UCTRLPawnStateTreeComponent* Second = SpawnPawnWithStateTree(*World, StateTree, FVector(100., 0., 0.), false);
+	if (!TestTrue(TEXT("Second tree running"), Second && Second->IsRunning())) { return false; }
+	TestTrue(TEXT("Second tree runs on the first tree's allocation"), GetInstanceMemory(*Second) == FirstMemory);
+
+	FCTRLStateTreeInstanceDataPool const* Pool = PoolSubsystem->FindPool(StateTree);
+	if (TestNotNull(TEXT("Pool for the sample tree"), Pool))
+	{
+		TestEqual(TEXT("Pool hits"), Pool->NumHits, 2);
+		TestEqual(TEXT("Pool misses"), Pool->NumMisses, 1);
+	}
+	return true;
+}
+
+#endif
@@ -0,0 +1,89 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTree/Tests/CTRLStateTreeTestUtils.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "AIController.h"
+#include "StateTree.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLPawnStateTreeSchema.h"
+#include "CTRLStateTree/Tasks/CTRLPrintTextTask.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include "GameFramework/Pawn.h"
+
+#if WITH_EDITOR
+#include "StateTreeCompiler.h"
+#include "StateTreeCompilerLog.h"
+#include "StateTreeEditorData.h"
+#include "StateTreeState.h"
+#endif
+
+namespace CTRL::StateTree::Tests
+{
+	UWorld* CreateTestWorld(TCHAR const* Name)
+	{
+		UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, Name);
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+		return World;
+	}
+
+	void DestroyTestWorld(UWorld* World)
+	{
+		GEngine->DestroyWorldContext(World);
+		World->DestroyWorld(false);
+	}
+
+	UCTRLPawnStateTreeComponent* SpawnPawnWithStateTree(UWorld& World, UStateTree* StateTree, FVector const& Location, bool const bUseBatchedTick)
+	{
+		FActorSpawnParameters SpawnParameters;
+		SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+		APawn* Pawn = World.SpawnActor<APawn>(Location, FRotator::ZeroRotator, SpawnParameters);
+		AAIController* Controller = World.SpawnActor<AAIController>(SpawnParameters);
+		if (!Pawn || !Controller) { return nullptr; }
+
+		auto const Component = NewObject<UCTRLPawnStateTreeComponent>(Controller);
+		Component->SoftStateTree = StateTree;
+		Component->bUseBatchedTick = bUseBatchedTick;
+		// registering on an actor that already begun play starts the logic
+		Component->RegisterComponent();
+		Controller->Possess(Pawn);
+		return Component;
+	}
+
+#if WITH_EDITOR
+	UStateTree* BuildSampleStateTree()
+	{
+		UStateTree* StateTree = NewObject<UStateTree>(GetTransientPackage(), NAME_None, RF_Transient);
+		UStateTreeEditorData* EditorData = NewObject<UStateTreeEditorData>(StateTree);
+		StateTree->EditorData = EditorData;
+		EditorData->Schema = NewObject<UCTRLPawnStateTreeSchema>(EditorData);
+
+		UStateTreeState& Root = EditorData->AddSubTree(TEXT("Root"));
+		UStateTreeState& StateA = Root.AddChildState(TEXT("A"));
+		UStateTreeState& StateB = Root.AddChildState(TEXT("B"));
+		// printing is off, the tasks only run their enter & exit
+		for (UStateTreeState* State : {&Root, &StateA, &StateB})
+		{
+			TStateTreeEditorNode<FCTRLPrintTextTask>& PrintTask = State->AddTask<FCTRLPrintTextTask>();
+			PrintTask.GetInstanceData().OnEnter.bEnabled = false;
+		}
+		StateA.AddTransition(EStateTreeTransitionTrigger::OnTick, EStateTreeTransitionType::GotoState, &StateB);
+		StateB.AddTransition(EStateTreeTransitionTrigger::OnTick, EStateTreeTransitionType::GotoState, &StateA);
+
+		FStateTreeCompilerLog Log;
+		FStateTreeCompiler Compiler(Log);
+		return Compiler.Compile(*StateTree) ? StateTree : nullptr;
+	}
+#endif
+}
+
+#endif
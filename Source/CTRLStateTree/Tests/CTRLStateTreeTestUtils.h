@@ -0,0 +1,32 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+class UCTRLPawnStateTreeComponent;
+class UStateTree;
+class UWorld;
+
+namespace CTRL::StateTree::Tests
+{
+	// Transient game world that has begun play, with its own world context
+	UWorld* CreateTestWorld(TCHAR const* Name);
+	void DestroyTestWorld(UWorld* World);
+
+	// Spawns a pawn possessed by an AI controller owning a pawn state tree component running StateTree (if set)
+	UCTRLPawnStateTreeComponent* SpawnPawnWithStateTree(UWorld& World, UStateTree* StateTree, FVector const& Location, bool bUseBatchedTick);
+
+#if WITH_EDITOR
+	/*
+	 * Pawn schema tree compiled in code from CTRL Print Text tasks: a root state and two child states switching
+	 * to each other on tick, so every tick exits & enters a state. Null if the compile failed.
+	 */
+	UStateTree* BuildSampleStateTree();
+#endif
+}
+
+#endif
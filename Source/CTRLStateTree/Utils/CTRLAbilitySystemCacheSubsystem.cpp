@@ -0,0 +1,98 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLAbilitySystemCacheSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemGlobals.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include "GameFramework/Actor.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLAbilitySystemCacheSubsystem)
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ability System Cache Hits"), STAT_CTRLStateTree_AbilitySystemCacheHits, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ability System Cache Misses"), STAT_CTRLStateTree_AbilitySystemCacheMisses, STATGROUP_CTRLStateTree);
+
+UCTRLAbilitySystemCacheSubsystem* UCTRLAbilitySystemCacheSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLAbilitySystemCacheSubsystem>();
+}
+
+UAbilitySystemComponent* UCTRLAbilitySystemCacheSubsystem::FindAbilitySystem(AActor const* Actor)
+{
+	if (!IsValid(Actor)) { return nullptr; }
+	UWorld const* World = Actor->GetWorld();
+	if (auto const Cache = World ? World->GetSubsystem<UCTRLAbilitySystemCacheSubsystem>() : nullptr)
+	{
+		return Cache->GetAbilitySystem(Actor);
+	}
+	return UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor);
+}
+
+bool UCTRLAbilitySystemCacheSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLAbilitySystemCacheSubsystem::Deinitialize()
+{
+	for (TPair<TObjectKey<AActor>, TWeakObjectPtr<UAbilitySystemComponent>> const& Pair : AbilitySystems)
+	{
+		if (AActor* Actor = Pair.Key.ResolveObjectPtr())
+		{
+			Actor->OnDestroyed.RemoveDynamic(this, &ThisClass::HandleActorDestroyed);
+		}
+	}
+	AbilitySystems.Empty();
+	Super::Deinitialize();
+}
+
+UAbilitySystemComponent* UCTRLAbilitySystemCacheSubsystem::GetAbilitySystem(AActor const* Actor)
+{
+	if (!IsValid(Actor)) { return nullptr; }
+	TObjectKey<AActor> const ActorKey(Actor);
+	if (TWeakObjectPtr<UAbilitySystemComponent> const* Cached = AbilitySystems.Find(ActorKey))
+	{
+		UAbilitySystemComponent* AbilitySystem = Cached->Get();
+		if (AbilitySystem && (AbilitySystem->GetOwnerActor() == Actor || AbilitySystem->GetAvatarActor() == Actor))
+		{
+			INC_DWORD_STAT(STAT_CTRLStateTree_AbilitySystemCacheHits);
+			return AbilitySystem;
+		}
+	}
+
+	INC_DWORD_STAT(STAT_CTRLStateTree_AbilitySystemCacheMisses);
+	UAbilitySystemComponent* AbilitySystem = UAbilitySystemGlobals::GetAbilitySystemComponentFromActor(Actor);
+	if (!AbilitySystem)
+	{
+		Invalidate(Actor);
+		return nullptr;
+	}
+	if (!AbilitySystems.Contains(ActorKey))
+	{
+		const_cast<AActor*>(Actor)->OnDestroyed.AddUniqueDynamic(this, &ThisClass::HandleActorDestroyed);
+	}
+	AbilitySystems.Add(ActorKey, AbilitySystem);
+	return AbilitySystem;
+}
+
+void UCTRLAbilitySystemCacheSubsystem::Invalidate(AActor const* Actor)
+{
+	if (AbilitySystems.Remove(TObjectKey<AActor>(Actor)) == 0) { return; }
+	if (Actor)
+	{
+		const_cast<AActor*>(Actor)->OnDestroyed.RemoveDynamic(this, &ThisClass::HandleActorDestroyed);
+	}
+}
+
+void UCTRLAbilitySystemCacheSubsystem::HandleActorDestroyed(AActor* DestroyedActor)
+{
+	AbilitySystems.Remove(TObjectKey<AActor>(DestroyedActor));
+}
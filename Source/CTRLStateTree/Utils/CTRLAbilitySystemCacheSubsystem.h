@@ -0,0 +1,46 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "CTRLAbilitySystemCacheSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+
+/*
+ * Caches UAbilitySystemGlobals::GetAbilitySystemComponentFromActor per actor for the CTRL GAS tasks,
+ * which otherwise resolve the ASC (interface cast, sometimes a component search) on every event.
+ * Entries are dropped when the actor is destroyed, and re-resolved when the component was destroyed
+ * or no longer has the actor as owner or avatar (e.g. a player state ASC after possession changed).
+ * Actors without an ASC aren't cached, one may be added later.
+ */
+UCLASS(DisplayName="Ability System Cache Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLAbilitySystemCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLAbilitySystemCacheSubsystem* Get(UObject const* WorldContextObject);
+
+	// Cached ASC of Actor from its world's subsystem, uncached in worlds without one (e.g. editor)
+	static UAbilitySystemComponent* FindAbilitySystem(AActor const* Actor);
+
+	UAbilitySystemComponent* GetAbilitySystem(AActor const* Actor);
+	void Invalidate(AActor const* Actor);
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	UFUNCTION()
+	void HandleActorDestroyed(AActor* DestroyedActor);
+
+	TMap<TObjectKey<AActor>, TWeakObjectPtr<UAbilitySystemComponent>> AbilitySystems;
+};
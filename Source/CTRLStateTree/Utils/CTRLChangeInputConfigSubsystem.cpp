@@ -3,13 +3,9 @@
 
 #include "CTRLChangeInputConfigSubsystem.h"
 
-#include "TimerManager.h"
-
 #include "Blueprint/UserWidget.h"
 #include "Blueprint/WidgetBlueprintLibrary.h"
 
-#include "CTRLCore/CTRLUnique.h"
-
 #include "CTRLStateTree/CTRLStateTree.h"
 
 #include "Components/Viewport.h"
@@ -21,6 +17,8 @@
 
 #include "Framework/Application/SlateApplication.h"
 
+#include "HAL/IConsoleManager.h"
+
 #include "Kismet/GameplayStatics.h"
 
 #include "Slate/SceneViewport.h"
@@ -32,9 +30,183 @@ DEFINE_LOG_CATEGORY(LogCTRLChangeInputConfigSubsystem)
 #define CICS_LOG(Verbosity, ...) UE_LOG(LogCTRLChangeInputConfigSubsystem, Verbosity, ##__VA_ARGS__)
 #define CICS_CLOG(Cond, Verbosity, ...) UE_CLOG(Cond, LogCTRLChangeInputConfigSubsystem, Verbosity, ##__VA_ARGS__)
 
-FString LexToStringOptionalHandle(TOptional<FGuid> const& Guid)
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Skipped Input Config Setters"), STAT_CTRLStateTree_SkippedInputConfigSetters, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Input Config Setter Calls"), STAT_CTRLStateTree_InputConfigSetterCalls, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Input Config Push"), STAT_CTRLStateTree_InputConfigPush, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Input Config Pop"), STAT_CTRLStateTree_InputConfigPop, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Input Config Apply"), STAT_CTRLStateTree_InputConfigApply, STATGROUP_CTRLStateTree);
+
+namespace CTRL::ChangeInputConfig::Private
+{
+	// marks guids created by FCTRLInputConfigHandle::ToGuid
+	constexpr uint32 GuidTag = 0x4354524C;
+
+	// FCTRLPackedInputModeConfig layout
+	namespace Packed
+	{
+		constexpr uint32 InputModeShift = 0; // 2 bits
+		constexpr uint32 OverrideInputModeDefault = 1u << 2;
+		constexpr uint32 FlushInput = 1u << 3;
+		constexpr uint32 OverrideIgnoreMoveInput = 1u << 4;
+		constexpr uint32 IgnoreMoveInput = 1u << 5;
+		constexpr uint32 OverrideIgnoreLookInput = 1u << 6;
+		constexpr uint32 IgnoreLookInput = 1u << 7;
+		constexpr uint32 ShowMouseCursor = 1u << 8;
+		constexpr uint32 CenterMouseOnSet = 1u << 9;
+		constexpr uint32 OverrideMouseCursor = 1u << 10;
+		constexpr uint32 MouseCursorShift = 11; // 4 bits
+		constexpr uint32 OverrideMouseLock = 1u << 15;
+		constexpr uint32 MouseLockModeShift = 16; // 2 bits
+		constexpr uint32 OverrideMouseCapture = 1u << 18;
+		constexpr uint32 MouseCaptureModeShift = 19; // 3 bits
+		constexpr uint32 HideCursorDuringCapture = 1u << 22;
+		// no value, WidgetToFocus is kept next to the bits
+		constexpr uint32 WidgetToFocus = 1u << 23;
+
+		constexpr uint32 InputMode = 0x3u << InputModeShift;
+		constexpr uint32 MouseCursor = 0xFu << MouseCursorShift;
+		constexpr uint32 MouseLockMode = 0x3u << MouseLockModeShift;
+		constexpr uint32 MouseCaptureMode = 0x7u << MouseCaptureModeShift;
+
+		// fields folded by every config
+		constexpr uint32 Always = InputMode | OverrideInputModeDefault | FlushInput;
+		constexpr uint32 IgnoreMove = OverrideIgnoreMoveInput | IgnoreMoveInput;
+		constexpr uint32 IgnoreLook = OverrideIgnoreLookInput | IgnoreLookInput;
+		constexpr uint32 Cursor = OverrideMouseCursor | MouseCursor;
+		constexpr uint32 Lock = OverrideMouseLock | MouseLockMode;
+		constexpr uint32 Capture = OverrideMouseCapture | MouseCaptureMode | HideCursorDuringCapture;
+
+		uint32 Flag(bool const bValue, uint32 const Bit) { return bValue ? Bit : 0u; }
+
+		template <typename TEnum>
+		uint32 Field(TEnum const Value, uint32 const Shift, uint32 const Mask)
+		{
+			uint32 const Bits = static_cast<uint32>(Value) << Shift;
+			ensureMsgf((Bits & ~Mask) == 0, TEXT("Value %d doesn't fit its packed field"), static_cast<int32>(Value));
+			return Bits & Mask;
+		}
+
+		template <typename TEnum>
+		TEnum GetField(uint32 const Values, uint32 const Shift, uint32 const Mask)
+		{
+			return static_cast<TEnum>((Values & Mask) >> Shift);
+		}
+	}
+
+	// Slate, viewport & player controller setter calls made by applies, read by CTRL.InputConfig.Benchmark
+	uint64 NumSetterCalls = 0;
+
+	void CountSetterCalls(int32 const Num = 1)
+	{
+		NumSetterCalls += Num;
+		INC_DWORD_STAT_BY(STAT_CTRLStateTree_InputConfigSetterCalls, Num);
+	}
+
+	// Whether a setter for Fields has to be called, counts the skipped ones
+	bool HasChanged(ECTRLInputConfigChange const Changes, ECTRLInputConfigChange const Fields)
+	{
+		if (EnumHasAnyFlags(Changes, Fields)) return true;
+		INC_DWORD_STAT(STAT_CTRLStateTree_SkippedInputConfigSetters);
+		return false;
+	}
+}
+
+FGuid FCTRLInputConfigHandle::ToGuid() const
 {
-	return Guid.IsSet() ? Guid.GetValue().ToString() : TEXT("None");
+	using namespace CTRL::ChangeInputConfig::Private;
+	return FGuid(static_cast<uint32>(Index), static_cast<uint32>(Generation), GuidTag, GuidTag);
+}
+
+FCTRLInputConfigHandle FCTRLInputConfigHandle::FromGuid(FGuid const& Guid)
+{
+	using namespace CTRL::ChangeInputConfig::Private;
+	if (Guid.C != GuidTag || Guid.D != GuidTag) { return {}; }
+	return {static_cast<int32>(Guid.A), static_cast<int32>(Guid.B)};
+}
+
+FCTRLPackedInputModeConfig FCTRLPackedInputModeConfig::Pack(FCTRLInputModeConfig const& InputConfig)
+{
+	using namespace CTRL::ChangeInputConfig::Private::Packed;
+	FCTRLPackedInputModeConfig Packed;
+	Packed.Values = Field(InputConfig.InputMode, InputModeShift, InputMode)
+		| Flag(InputConfig.bOverrideInputModeDefault, OverrideInputModeDefault)
+		| Flag(InputConfig.bFlushInput, FlushInput)
+		| Flag(InputConfig.IgnoreInputConfig.bOverrideIgnoreMoveInput, OverrideIgnoreMoveInput)
+		| Flag(InputConfig.IgnoreInputConfig.bIgnoreMoveInput, IgnoreMoveInput)
+		| Flag(InputConfig.IgnoreInputConfig.bOverrideIgnoreLookInput, OverrideIgnoreLookInput)
+		| Flag(InputConfig.IgnoreInputConfig.bIgnoreLookInput, IgnoreLookInput)
+		| Flag(InputConfig.bShowMouseCursor, ShowMouseCursor)
+		| Flag(InputConfig.CenterMouseOnSet, CenterMouseOnSet)
+		| Flag(InputConfig.bOverrideMouseCursor, OverrideMouseCursor)
+		| Field(InputConfig.MouseCursor, MouseCursorShift, MouseCursor)
+		| Flag(InputConfig.bOverrideMouseLock, OverrideMouseLock)
+		| Field(InputConfig.MouseLockMode, MouseLockModeShift, MouseLockMode)
+		| Flag(InputConfig.bOverrideMouseCapture, OverrideMouseCapture)
+		| Field(InputConfig.MouseCaptureMode, MouseCaptureModeShift, MouseCaptureMode)
+		| Flag(InputConfig.bHideCursorDuringCapture, HideCursorDuringCapture);
+
+	// same rules as the accessors of FCTRLInputModeConfig
+	Packed.Overrides = Always
+		| Flag(InputConfig.OverrideIgnoreMoveInput(), IgnoreMove)
+		| Flag(InputConfig.OverridesIgnoreLookInput(), IgnoreLook)
+		| Flag(InputConfig.SetsShowMouseCursor(), ShowMouseCursor | CenterMouseOnSet)
+		| Flag(InputConfig.OverridesMouseCursor(), Cursor)
+		| Flag(InputConfig.OverrideMouseLock(), Lock)
+		| Flag(InputConfig.OverrideMouseCapture(), Capture)
+		| Flag(InputConfig.InputMode != ECTRLInputMode::GameOnly, WidgetToFocus);
+	Packed.WidgetToFocus = InputConfig.WidgetToFocus;
+	return Packed;
+}
+
+FCTRLInputModeConfig FCTRLPackedInputModeConfig::Unpack() const
+{
+	using namespace CTRL::ChangeInputConfig::Private::Packed;
+	FCTRLInputModeConfig InputConfig;
+	InputConfig.InputMode = GetField<ECTRLInputMode>(Values, InputModeShift, InputMode);
+	InputConfig.bOverrideInputModeDefault = !!(Values & OverrideInputModeDefault);
+	InputConfig.bFlushInput = !!(Values & FlushInput);
+	InputConfig.IgnoreInputConfig.bOverrideIgnoreMoveInput = !!(Values & OverrideIgnoreMoveInput);
+	InputConfig.IgnoreInputConfig.bIgnoreMoveInput = !!(Values & IgnoreMoveInput);
+	InputConfig.IgnoreInputConfig.bOverrideIgnoreLookInput = !!(Values & OverrideIgnoreLookInput);
+	InputConfig.IgnoreInputConfig.bIgnoreLookInput = !!(Values & IgnoreLookInput);
+	InputConfig.bShowMouseCursor = !!(Values & ShowMouseCursor);
+	InputConfig.CenterMouseOnSet = !!(Values & CenterMouseOnSet);
+	InputConfig.bOverrideMouseCursor = !!(Values & OverrideMouseCursor);
+	InputConfig.MouseCursor = GetField<ECTRLMouseCursor>(Values, MouseCursorShift, MouseCursor);
+	InputConfig.bOverrideMouseLock = !!(Values & OverrideMouseLock);
+	InputConfig.MouseLockMode = GetField<EMouseLockMode>(Values, MouseLockModeShift, MouseLockMode);
+	InputConfig.bOverrideMouseCapture = !!(Values & OverrideMouseCapture);
+	InputConfig.MouseCaptureMode = GetField<EMouseCaptureMode>(Values, MouseCaptureModeShift, MouseCaptureMode);
+	InputConfig.bHideCursorDuringCapture = !!(Values & HideCursorDuringCapture);
+	InputConfig.WidgetToFocus = WidgetToFocus;
+	return InputConfig;
+}
+
+void FCTRLPackedInputModeConfig::Fold(FCTRLPackedInputModeConfig const& InputConfig)
+{
+	Values = (Values & ~InputConfig.Overrides) | (InputConfig.Values & InputConfig.Overrides);
+	Overrides |= InputConfig.Overrides;
+	if (InputConfig.Overrides & CTRL::ChangeInputConfig::Private::Packed::WidgetToFocus)
+	{
+		WidgetToFocus = InputConfig.WidgetToFocus;
+	}
+}
+
+ECTRLInputConfigChange FCTRLPackedInputModeConfig::Diff(FCTRLPackedInputModeConfig const& InputConfig) const
+{
+	using namespace CTRL::ChangeInputConfig::Private::Packed;
+	uint32 const Changed = Values ^ InputConfig.Values;
+	// flush & centering are actions taken on apply, not state
+	ECTRLInputConfigChange Changes = ECTRLInputConfigChange::None;
+	if (Changed & (InputMode | OverrideInputModeDefault)) { Changes |= ECTRLInputConfigChange::InputMode; }
+	if (Changed & IgnoreMove) { Changes |= ECTRLInputConfigChange::IgnoreMoveInput; }
+	if (Changed & IgnoreLook) { Changes |= ECTRLInputConfigChange::IgnoreLookInput; }
+	if (Changed & ShowMouseCursor) { Changes |= ECTRLInputConfigChange::ShowMouseCursor; }
+	if (Changed & Cursor) { Changes |= ECTRLInputConfigChange::MouseCursor; }
+	if (Changed & Lock) { Changes |= ECTRLInputConfigChange::MouseLock; }
+	if (Changed & Capture) { Changes |= ECTRLInputConfigChange::MouseCapture; }
+	if (WidgetToFocus != InputConfig.WidgetToFocus) { Changes |= ECTRLInputConfigChange::WidgetToFocus; }
+	return Changes;
 }
 
 UCTRLChangeInputConfigSubsystem* UCTRLChangeInputConfigSubsystem::Get(ULocalPlayer const* LocalPlayer)
@@ -49,77 +221,164 @@ UCTRLChangeInputConfigSubsystem* UCTRLChangeInputConfigSubsystem::Get(APlayerCon
 
 void UCTRLChangeInputConfigSubsystem::Deinitialize()
 {
-	if (auto const World = GetWorld())
-	{
-		World->GetTimerManager().ClearAllTimersForObject(this);
-	}
+	bUpdatePending = false;
+	BatchDepth = 0;
 	InputConfigHandleStack.Empty();
-	InputConfigs.Empty();
+	InputConfigSlots.Empty();
+	FreeInputConfigSlots.Empty();
+	NumStaleInputConfigHandles = 0;
+	FoldedInputConfigStack.Empty();
+	NumFoldedInputConfigs = 0;
 	CurrentInputConfigHandle.Reset();
 	OnInputConfigEnqueued.Clear();
 	OnInputConfigChanged.Clear();
 	EnqueuedInputConfigs.Empty();
+	AppliedInputConfig.Reset();
 	Super::Deinitialize();
 }
 
-TOptional<FCTRLInputModeConfig> UCTRLChangeInputConfigSubsystem::GetInputConfig(TOptional<FGuid> const& InputConfigHandle) const
+bool UCTRLChangeInputConfigSubsystem::IsHandleValid(FCTRLInputConfigHandle const& InputConfigHandle) const
 {
-	if (!InputConfigHandle.IsSet()) return {};
-	FGuid const Key = InputConfigHandle.GetValue();
-	if (!InputConfigs.Contains(Key))
-	{
-		ensure(!InputConfigHandleStack.Contains(Key));
-		ensure(!EnqueuedInputConfigs.Contains(Key));
-		return {};
-	}
-	return InputConfigs[Key];
+	if (!InputConfigSlots.IsValidIndex(InputConfigHandle.Index)) return false;
+	FCTRLInputConfigSlot const& Slot = InputConfigSlots[InputConfigHandle.Index];
+	return Slot.bInUse && Slot.Generation == InputConfigHandle.Generation;
 }
 
-FString UCTRLChangeInputConfigSubsystem::DescribeHandle(TOptional<FGuid> InputConfigHandle) const
+FCTRLPackedInputModeConfig const* UCTRLChangeInputConfigSubsystem::FindPackedInputConfig(FCTRLInputConfigHandle const& InputConfigHandle) const
 {
-	auto const InputConfig = GetInputConfig(InputConfigHandle);
-	if (!InputConfig.IsSet()) return TEXT("None");
-	auto const ShortId = UCTRLUnique::GetUnambiguousShortId(TSet<FGuid>(InputConfigHandleStack), InputConfigHandle.GetValue());
-	auto const Index = InputConfigHandleStack.IndexOfByKey(InputConfigHandle.GetValue());
-	return FString::Printf(TEXT("%d:%s %s"), Index, *ShortId, *UEnum::GetDisplayValueAsText(InputConfig->InputMode).ToString());
+	return IsHandleValid(InputConfigHandle) ? &InputConfigSlots[InputConfigHandle.Index].PackedInputConfig : nullptr;
 }
 
-FGuid UCTRLChangeInputConfigSubsystem::GetNextGuid(FCTRLInputModeConfig const& InputConfig) const
+TOptional<FCTRLInputModeConfig> UCTRLChangeInputConfigSubsystem::FindInputConfig(FCTRLInputConfigHandle const& InputConfigHandle) const
 {
-	auto const Hash = GetTypeHash(InputConfig);
-	FBlake3 HashBuilder;
-	HashBuilder.Update(&Hash, sizeof(Hash));
-	for (auto [Guid, Config] : InputConfigs)
-	{
-		auto InnerHash = GetTypeHash(Config);
-		HashBuilder.Update(&InnerHash, sizeof(InnerHash));
-	}
-	return FGuid::NewGuidFromHash(HashBuilder.Finalize());
+	FCTRLPackedInputModeConfig const* PackedInputConfig = FindPackedInputConfig(InputConfigHandle);
+	if (!PackedInputConfig) return {};
+	return PackedInputConfig->Unpack();
 }
 
-FGuid UCTRLChangeInputConfigSubsystem::PushInputConfig(FCTRLInputModeConfig const& InputConfig)
+FCTRLInputConfigHandle UCTRLChangeInputConfigSubsystem::FindHandle(FGuid const& InputConfigGuid) const
+{
+	FCTRLInputConfigHandle const Handle = FCTRLInputConfigHandle::FromGuid(InputConfigGuid);
+	if (IsHandleValid(Handle)) return Handle;
+	// guids that don't encode a handle: caller supplied ones from PushInputConfig(Config, Guid), including the ones
+	// reserved off the game thread. Matched against the slot guids, the stack is a handful of entries
+	FCTRLInputConfigHandle const* ExternalHandle = InputConfigHandleStack.FindByPredicate(
+		[this, &InputConfigGuid](FCTRLInputConfigHandle const& InputConfigHandle)
+		{
+			return IsHandleValid(InputConfigHandle) && InputConfigSlots[InputConfigHandle.Index].Guid == InputConfigGuid;
+		}
+	);
+	return ExternalHandle ? *ExternalHandle : FCTRLInputConfigHandle();
+}
+
+TOptional<FCTRLInputModeConfig> UCTRLChangeInputConfigSubsystem::GetInputConfig(TOptional<FGuid> const& InputConfigGuid) const
 {
-	FGuid const InputConfigHandle = GetNextGuid(InputConfig);
+	if (!InputConfigGuid.IsSet()) return {};
+	return FindInputConfig(FindHandle(InputConfigGuid.GetValue()));
+}
+
+FString UCTRLChangeInputConfigSubsystem::DescribeHandle(TOptional<FCTRLInputConfigHandle> InputConfigHandle) const
+{
+	if (!InputConfigHandle.IsSet()) return TEXT("None");
+	TOptional<FCTRLInputModeConfig> const InputConfig = FindInputConfig(InputConfigHandle.GetValue());
+	if (!InputConfig.IsSet()) return TEXT("None");
+	auto const Index = InputConfigHandleStack.IndexOfByKey(InputConfigHandle.GetValue());
+	return FString::Printf(TEXT("%d:%s %s"), Index, *InputConfigHandle->ToString(), *UEnum::GetDisplayValueAsText(InputConfig->InputMode).ToString());
+}
+
+FCTRLInputConfigHandle UCTRLChangeInputConfigSubsystem::AddInputConfig(FCTRLInputModeConfig const& InputConfig, FGuid const& InputConfigGuid)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_InputConfigPush);
+	int32 const SlotIndex = FreeInputConfigSlots.IsEmpty() ? InputConfigSlots.AddDefaulted() : FreeInputConfigSlots.Pop(EAllowShrinking::No);
+	FCTRLInputConfigSlot& Slot = InputConfigSlots[SlotIndex];
+	Slot.PackedInputConfig = FCTRLPackedInputModeConfig::Pack(InputConfig);
+	Slot.bInUse = true;
+	Slot.StackIndex = InputConfigHandleStack.Num();
+	FCTRLInputConfigHandle const InputConfigHandle{SlotIndex, Slot.Generation};
+	Slot.Guid = InputConfigGuid.IsValid() ? InputConfigGuid : InputConfigHandle.ToGuid();
+
 	InputConfigHandleStack.Push(InputConfigHandle);
-	InputConfigs.Add(InputConfigHandle, InputConfig);
-	CICS_LOG(Verbose, TEXT("PushInputConfig: %s %s"), *DescribeHandle(InputConfigHandle), *InputConfigHandle.ToString());
+	CICS_LOG(Verbose, TEXT("PushInputConfig: %s %s"), *DescribeHandle(InputConfigHandle), *Slot.Guid.ToString());
 	EnqueuedInputConfigs.Add(InputConfigHandle);
 	ScheduleUpdate();
 	return InputConfigHandle;
 }
 
-void UCTRLChangeInputConfigSubsystem::PopInputConfig(FGuid const& InputConfigHandle)
+FCTRLInputConfigHandle UCTRLChangeInputConfigSubsystem::PushInputConfigHandle(FCTRLInputModeConfig const& InputConfig)
 {
-	if (!ensure(InputConfigHandleStack.Contains(InputConfigHandle))) return;
+	return AddInputConfig(InputConfig, FGuid());
+}
+
+FGuid UCTRLChangeInputConfigSubsystem::PushInputConfig(FCTRLInputModeConfig const& InputConfig)
+{
+	return PushInputConfigHandle(InputConfig).ToGuid();
+}
+
+void UCTRLChangeInputConfigSubsystem::PushInputConfig(FCTRLInputModeConfig const& InputConfig, FGuid const& InputConfigGuid)
+{
+	AddInputConfig(InputConfig, InputConfigGuid);
+}
+
+void UCTRLChangeInputConfigSubsystem::PopInputConfig(FCTRLInputConfigHandle const& InputConfigHandle)
+{
+	if (!ensure(IsHandleValid(InputConfigHandle))) return;
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_InputConfigPop);
 	CICS_LOG(Verbose, TEXT("PopInputConfig: %s "), *DescribeHandle(InputConfigHandle));
-	EnqueuedInputConfigs.Remove(InputConfigHandle);
-	InputConfigHandleStack.Remove(InputConfigHandle);
-	ensure(InputConfigs.Contains(InputConfigHandle));
-	InputConfigs.Remove(InputConfigHandle);
+	FCTRLInputConfigSlot& Slot = InputConfigSlots[InputConfigHandle.Index];
+	Slot.bInUse = false;
+	++Slot.Generation;
+	// drop the WidgetToFocus reference
+	Slot.PackedInputConfig = FCTRLPackedInputModeConfig();
+	Slot.Guid.Invalidate();
+	// the folded configs above it included this one
+	NumFoldedInputConfigs = FMath::Min(NumFoldedInputConfigs, Slot.StackIndex);
+	Slot.StackIndex = INDEX_NONE;
+	++NumStaleInputConfigHandles;
+	FreeInputConfigSlots.Push(InputConfigHandle.Index);
+	TrimInputConfigHandleStack();
 	ScheduleUpdate();
 }
 
-TOptional<FGuid> UCTRLChangeInputConfigSubsystem::PeekInputConfigStack() const
+void UCTRLChangeInputConfigSubsystem::PopInputConfig(FGuid const& InputConfigGuid)
+{
+	PopInputConfig(FindHandle(InputConfigGuid));
+}
+
+void UCTRLChangeInputConfigSubsystem::TrimInputConfigHandleStack()
+{
+	while (!InputConfigHandleStack.IsEmpty() && !IsHandleValid(InputConfigHandleStack.Last()))
+	{
+		InputConfigHandleStack.Pop(EAllowShrinking::No);
+		--NumStaleInputConfigHandles;
+	}
+	NumFoldedInputConfigs = FMath::Min(NumFoldedInputConfigs, InputConfigHandleStack.Num());
+}
+
+void UCTRLChangeInputConfigSubsystem::CompactInputConfigHandleStack()
+{
+	if (NumStaleInputConfigHandles <= 0) return;
+	// popped handles don't change the folded config, so the folds below NumFoldedInputConfigs stay valid
+	int32 NumKept = 0;
+	int32 NumFoldedKept = 0;
+	for (int32 Index = 0; Index < InputConfigHandleStack.Num(); ++Index)
+	{
+		FCTRLInputConfigHandle const InputConfigHandle = InputConfigHandleStack[Index];
+		if (!IsHandleValid(InputConfigHandle)) continue;
+		InputConfigSlots[InputConfigHandle.Index].StackIndex = NumKept;
+		InputConfigHandleStack[NumKept] = InputConfigHandle;
+		if (Index < NumFoldedInputConfigs)
+		{
+			FoldedInputConfigStack[NumKept] = MoveTemp(FoldedInputConfigStack[Index]);
+			NumFoldedKept = NumKept + 1;
+		}
+		++NumKept;
+	}
+	InputConfigHandleStack.SetNum(NumKept, EAllowShrinking::No);
+	NumFoldedInputConfigs = NumFoldedKept;
+	NumStaleInputConfigHandles = 0;
+}
+
+TOptional<FCTRLInputConfigHandle> UCTRLChangeInputConfigSubsystem::PeekInputConfigStack() const
 {
 	if (!InputConfigHandleStack.Num()) return {};
 	return InputConfigHandleStack.Last();
@@ -127,85 +386,107 @@ TOptional<FGuid> UCTRLChangeInputConfigSubsystem::PeekInputConfigStack() const
 
 TOptional<FCTRLInputModeConfig> UCTRLChangeInputConfigSubsystem::GetCurrentInputConfig() const
 {
-	if (!CurrentInputConfigHandle.IsSet() || !InputConfigs.Contains(CurrentInputConfigHandle.GetValue())) return {};
-	return InputConfigs[CurrentInputConfigHandle.GetValue()];
+	if (!CurrentInputConfigHandle.IsSet()) return {};
+	return FindInputConfig(CurrentInputConfigHandle.GetValue());
 }
 
 void UCTRLChangeInputConfigSubsystem::ScheduleUpdate()
 {
-	if (GetWorld()->GetTimerManager().IsTimerActive(ScheduledUpdateHandle)) return;
-	ScheduledUpdateHandle = GetWorld()->GetTimerManager().SetTimerForNextTick(this, &UCTRLChangeInputConfigSubsystem::Update);
+	bUpdatePending = true;
 }
 
-FCTRLInputModeConfig UCTRLChangeInputConfigSubsystem::GetInputConfigFromStack() const
+void UCTRLChangeInputConfigSubsystem::BeginBatch()
 {
-	TOptional<FCTRLInputModeConfig> InputConfigContext;
-	for (auto const InputConfigHandle : InputConfigHandleStack)
-	{
-		if (!InputConfigHandle.IsValid()) continue;
-		auto const InputConfig = GetInputConfig(InputConfigHandle);
-		if (!InputConfig.IsSet()) continue;
-		if (!InputConfigContext.IsSet())
-		{
-			InputConfigContext = InputConfig;
-			continue;
-		}
+	++BatchDepth;
+}
 
-		InputConfigContext->InputMode = InputConfig->InputMode;
-		InputConfigContext->bOverrideInputModeDefault = InputConfig->bOverrideInputModeDefault;
-		InputConfigContext->bFlushInput = InputConfig->bFlushInput;
-		if (InputConfig->OverridesIgnoreLookInput())
-		{
-			InputConfigContext->IgnoreInputConfig.bOverrideIgnoreLookInput = true;
-			InputConfigContext->IgnoreInputConfig.bIgnoreLookInput = InputConfig->IgnoreLookInput();
-		}
-		if (InputConfig->OverrideIgnoreMoveInput())
-		{
-			InputConfigContext->IgnoreInputConfig.bOverrideIgnoreMoveInput = true;
-			InputConfigContext->IgnoreInputConfig.bIgnoreMoveInput = InputConfig->IgnoreMoveInput();
-		}
-		if (InputConfig->SetsShowMouseCursor())
-		{
-			InputConfigContext->bShowMouseCursor = InputConfig->ShowMouseCursor();
-			InputConfigContext->CenterMouseOnSet = InputConfig->CenterMouseOnSet;
-		}
+void UCTRLChangeInputConfigSubsystem::EndBatch()
+{
+	if (!ensure(BatchDepth > 0)) return;
+	if (--BatchDepth > 0 || !bUpdatePending) return;
+	Update();
+}
 
-		if (InputConfig->OverridesMouseCursor())
-		{
-			InputConfigContext->bOverrideMouseCursor = true;
-			InputConfigContext->MouseCursor = InputConfig->MouseCursor;
-		}
+void UCTRLChangeInputConfigSubsystem::Tick(float const DeltaTime)
+{
+	Update();
+}
 
-		if (InputConfig->OverrideMouseLock())
-		{
-			InputConfigContext->bOverrideMouseLock = true;
-			InputConfigContext->MouseLockMode = InputConfig->MouseLockMode;
-		}
+ETickableTickType UCTRLChangeInputConfigSubsystem::GetTickableTickType() const
+{
+	return IsTemplate() ? ETickableTickType::Never : ETickableTickType::Conditional;
+}
 
-		if (InputConfig->OverrideMouseCapture())
-		{
-			InputConfigContext->bOverrideMouseCapture = true;
-			InputConfigContext->MouseCaptureMode = InputConfig->MouseCaptureMode;
-			InputConfigContext->bHideCursorDuringCapture = InputConfig->HideCursorDuringCapture();
-		}
+bool UCTRLChangeInputConfigSubsystem::IsTickable() const
+{
+	return bUpdatePending && !IsBatching();
+}
 
-		if (InputConfig->InputMode != ECTRLInputMode::GameOnly)
+TStatId UCTRLChangeInputConfigSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCTRLChangeInputConfigSubsystem, STATGROUP_CTRLStateTree);
+}
+
+FCTRLInputModeConfig UCTRLChangeInputConfigSubsystem::GetInputConfigFromStack() const
+{
+	TOptional<FCTRLPackedInputModeConfig> const PackedInputConfig = GetPackedInputConfigFromStack();
+	if (!PackedInputConfig.IsSet()) return {};
+	return PackedInputConfig->Unpack();
+}
+
+TOptional<FCTRLPackedInputModeConfig> UCTRLChangeInputConfigSubsystem::GetPackedInputConfigFromStack() const
+{
+	int32 const NumInputConfigs = InputConfigHandleStack.Num();
+	FoldedInputConfigStack.SetNum(NumInputConfigs, EAllowShrinking::No);
+	for (int32 Index = NumFoldedInputConfigs; Index < NumInputConfigs; ++Index)
+	{
+		TOptional<FCTRLPackedInputModeConfig> InputConfigContext = Index > 0 ? FoldedInputConfigStack[Index - 1] : TOptional<FCTRLPackedInputModeConfig>();
+		FCTRLInputConfigHandle const InputConfigHandle = InputConfigHandleStack[Index];
+		// popped, but not yet dropped from the stack
+		if (FCTRLPackedInputModeConfig const* InputConfig = FindPackedInputConfig(InputConfigHandle))
 		{
-			InputConfigContext->WidgetToFocus = InputConfig->WidgetToFocus;
+			if (InputConfigContext.IsSet())
+			{
+				InputConfigContext->Fold(*InputConfig);
+			}
+			else
+			{
+				InputConfigContext = *InputConfig;
+			}
 		}
+		FoldedInputConfigStack[Index] = MoveTemp(InputConfigContext);
 	}
-	if (!InputConfigContext.IsSet()) return {};
-	return InputConfigContext.GetValue();
+	NumFoldedInputConfigs = NumInputConfigs;
+
+	if (!NumInputConfigs) return {};
+	return FoldedInputConfigStack.Last();
 }
 
-void UCTRLChangeInputConfigSubsystem::InternalSetMouseCursor(FCTRLInputModeConfig const& InputConfig) const
+ECTRLInputConfigChange UCTRLChangeInputConfigSubsystem::DiffInputConfig(TOptional<FCTRLPackedInputModeConfig> const& PreviousInputConfig, FCTRLPackedInputModeConfig const& InputConfig)
 {
+	if (!PreviousInputConfig.IsSet()) return ECTRLInputConfigChange::All;
+	return PreviousInputConfig->Diff(InputConfig);
+}
+
+void UCTRLChangeInputConfigSubsystem::InternalSetMouseCursor(FCTRLInputModeConfig const& InputConfig, ECTRLInputConfigChange const Changes) const
+{
+	using namespace CTRL::ChangeInputConfig::Private;
 	auto const LocalPlayer = GetLocalPlayer();
 	if (!LocalPlayer) return;
 	auto const PC = LocalPlayer->GetPlayerController(GetWorld());
 	if (!IsValid(PC)) return;
 	auto const GameViewportClient = LocalPlayer->ViewportClient;
-	GameViewportClient->GetGameViewport()->CaptureMouse(true);
+	// no viewport when headless, e.g. in automation tests
+	if (!GameViewportClient) return;
+	bool const bInputModeChanged = HasChanged(Changes, ECTRLInputConfigChange::InputMode);
+	if (bInputModeChanged)
+	{
+		if (FSceneViewport* GameViewport = GameViewportClient->GetGameViewport())
+		{
+			GameViewport->CaptureMouse(true);
+			CountSetterCalls();
+		}
+	}
 	auto& SlateOperations = LocalPlayer->GetSlateOperations();
 	TSharedPtr<SViewport> const ViewportWidget = GameViewportClient->GetGameViewportWidget();
 	if (!ViewportWidget.IsValid()) return;
@@ -214,29 +495,36 @@ void UCTRLChangeInputConfigSubsystem::InternalSetMouseCursor(FCTRLInputModeConfi
 	{
 		case ECTRLInputMode::GameOnly:
 		{
+			if (!bInputModeChanged) break;
 			SlateOperations.UseHighPrecisionMouseMovement(ViewportWidgetRef);
 			SlateOperations.SetUserFocus(ViewportWidgetRef);
 			SlateOperations.LockMouseToWidget(ViewportWidgetRef);
 			SlateOperations.CaptureMouse(ViewportWidgetRef);
+			CountSetterCalls(4);
 
 			break;
 		}
 		case ECTRLInputMode::UIOnly: {}
 		case ECTRLInputMode::GameAndUI:
 		{
-			bool const bLockMouseToViewport = InputConfig.MouseLockMode == EMouseLockMode::LockAlways
-				|| (InputConfig.MouseLockMode == EMouseLockMode::LockInFullscreen && GameViewportClient->IsExclusiveFullscreenViewport());
-			if (bLockMouseToViewport)
+			if (HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::MouseLock))
 			{
-				SlateOperations.LockMouseToWidget(ViewportWidgetRef);
-			}
-			else
-			{
-				SlateOperations.ReleaseMouseLock();
+				bool const bLockMouseToViewport = InputConfig.MouseLockMode == EMouseLockMode::LockAlways
+					|| (InputConfig.MouseLockMode == EMouseLockMode::LockInFullscreen && GameViewportClient->IsExclusiveFullscreenViewport());
+				if (bLockMouseToViewport)
+				{
+					SlateOperations.LockMouseToWidget(ViewportWidgetRef);
+				}
+				else
+				{
+					SlateOperations.ReleaseMouseLock();
+				}
+				CountSetterCalls();
 			}
 			// GameViewportClient->SetIgnoreInput(false);
 			// GameViewportClient->SetHideCursorDuringCapture(InputConfig.bHideCursorDuringCapture);
 			// GameViewportClient->SetMouseCaptureMode(EMouseCaptureMode::CaptureDuringMouseDown);
+			if (!HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::WidgetToFocus)) break;
 			if (IsValid(InputConfig.WidgetToFocus))
 			{
 				SlateOperations.SetUserFocus(InputConfig.WidgetToFocus->TakeWidget());
@@ -245,46 +533,56 @@ void UCTRLChangeInputConfigSubsystem::InternalSetMouseCursor(FCTRLInputModeConfi
 			{
 				SlateOperations.SetUserFocus(ViewportWidgetRef);
 			}
+			CountSetterCalls();
 
 			break;
 		}
 	}
 	// GameViewportClient->SetMouseLockMode(EMouseLockMode::LockOnCapture);
 	// GameViewportClient->SetIgnoreInput(false);
-	if (InputConfig.OverridesMouseCursor())
+	if (InputConfig.OverridesMouseCursor() && HasChanged(Changes, ECTRLInputConfigChange::MouseCursor))
 	{
 		PC->CurrentMouseCursor = static_cast<EMouseCursor::Type>(InputConfig.MouseCursor);
+		CountSetterCalls();
 	}
-	if (InputConfig.OverrideMouseLock())
+	if (InputConfig.OverrideMouseLock() && HasChanged(Changes, ECTRLInputConfigChange::MouseLock))
 	{
 		GameViewportClient->SetMouseLockMode(InputConfig.MouseLockMode);
+		CountSetterCalls();
 	}
-	if (InputConfig.OverrideMouseCapture())
+	if (InputConfig.OverrideMouseCapture() && HasChanged(Changes, ECTRLInputConfigChange::MouseCapture))
 	{
 		GameViewportClient->SetHideCursorDuringCapture(InputConfig.bHideCursorDuringCapture);
 		GameViewportClient->SetMouseCaptureMode(InputConfig.MouseCaptureMode);
+		CountSetterCalls(2);
 	}
-	if (InputConfig.SetsShowMouseCursor())
+	bool const bShowMouseCursorChanged = HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::ShowMouseCursor);
+	if (InputConfig.SetsShowMouseCursor() && bShowMouseCursorChanged)
 	{
 		PC->SetShowMouseCursor(InputConfig.ShowMouseCursor());
+		CountSetterCalls();
 	}
-	if (InputConfig.CenterMouseOnSet)
+	// only when the cursor is (re)shown
+	if (InputConfig.CenterMouseOnSet && bShowMouseCursorChanged && GameViewportClient->Viewport)
 	{
 		auto const ViewportSize = GameViewportClient->Viewport->GetSizeXY();
 		PC->SetMouseLocation(ViewportSize.X / 2, ViewportSize.Y / 2);
+		CountSetterCalls();
 	}
-	if (InputConfig.bFlushInput)
+	if (InputConfig.bFlushInput && HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::WidgetToFocus))
 	{
 		PC->FlushPressedKeys();
+		CountSetterCalls();
 	}
 }
 
-void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid> InputConfigHandle)
+void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FCTRLInputConfigHandle> InputConfigHandle)
 {
 	auto const LocalPlayer = GetLocalPlayer();
 	if (!LocalPlayer) return;
 	auto const PC = LocalPlayer->GetPlayerController(GetWorld());
 	if (!IsValid(PC)) return;
+	using namespace CTRL::ChangeInputConfig::Private;
 	if (CurrentInputConfigHandle == InputConfigHandle) { return; } // already applied
 
 	bool const bHasInputConfig = CurrentInputConfigHandle.IsSet();
@@ -295,12 +593,13 @@ void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid
 		*DescribeHandle(CurrentInputConfigHandle)
 	);
 	CurrentInputConfigHandle = InputConfigHandle;
-	if (!GetInputConfig(InputConfigHandle))
+	if (!InputConfigHandle.IsSet() || !IsHandleValid(InputConfigHandle.GetValue()))
 	{
 		CICS_LOG(Log, TEXT("ApplyInputConfigFromHandle: Empty Input Config"));
 	}
 
-	auto const InputConfig = GetInputConfigFromStack();
+	FCTRLPackedInputModeConfig const PackedInputConfig = GetPackedInputConfigFromStack().Get(FCTRLPackedInputModeConfig::Pack(FCTRLInputModeConfig()));
+	FCTRLInputModeConfig const InputConfig = PackedInputConfig.Unpack();
 
 	CICS_LOG(
 		Verbose,
@@ -308,18 +607,40 @@ void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid
 		*InputConfig.ToString()
 	);
 
+	ECTRLInputConfigChange const Changes = DiffInputConfig(AppliedInputConfig, PackedInputConfig);
+	if (Changes == ECTRLInputConfigChange::None)
+	{
+		CICS_LOG(Verbose, TEXT("ApplyInputConfigFromHandle: Effective Input Config unchanged"));
+		INC_DWORD_STAT(STAT_CTRLStateTree_SkippedInputConfigSetters);
+		return;
+	}
+	// the input mode defaults set focus, mouse lock & capture as well
+	bool const bSetInputMode = HasChanged(
+		Changes,
+		ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::WidgetToFocus | ECTRLInputConfigChange::MouseLock | ECTRLInputConfigChange::MouseCapture
+	);
+	bool const bSetShowMouseCursor = HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::ShowMouseCursor);
+
 	switch (InputConfig.InputMode)
 	{
 		case ECTRLInputMode::GameOnly:
 		{
 			if (!InputConfig.bOverrideInputModeDefault)
 			{
-				UWidgetBlueprintLibrary::SetInputMode_GameOnly(PC, InputConfig.bFlushInput);
-				PC->SetShowMouseCursor(false);
+				if (bSetInputMode)
+				{
+					UWidgetBlueprintLibrary::SetInputMode_GameOnly(PC, InputConfig.bFlushInput);
+					CountSetterCalls();
+				}
+				if (bSetShowMouseCursor)
+				{
+					PC->SetShowMouseCursor(false);
+					CountSetterCalls();
+				}
 			}
 			else
 			{
-				InternalSetMouseCursor(InputConfig);
+				InternalSetMouseCursor(InputConfig, Changes);
 			}
 			break;
 		}
@@ -327,23 +648,35 @@ void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid
 		{
 			if (!InputConfig.bOverrideInputModeDefault)
 			{
-				UWidgetBlueprintLibrary::SetInputMode_GameAndUIEx(PC, InputConfig.WidgetToFocus, InputConfig.MouseLockMode, InputConfig.bHideCursorDuringCapture);
-				PC->SetShowMouseCursor(InputConfig.ShowMouseCursor());
+				if (bSetInputMode)
+				{
+					UWidgetBlueprintLibrary::SetInputMode_GameAndUIEx(PC, InputConfig.WidgetToFocus, InputConfig.MouseLockMode, InputConfig.bHideCursorDuringCapture);
+					CountSetterCalls();
+				}
+				if (bSetShowMouseCursor)
+				{
+					PC->SetShowMouseCursor(InputConfig.ShowMouseCursor());
+					CountSetterCalls();
+				}
 			}
 			else
 			{
-				InternalSetMouseCursor(InputConfig);
+				InternalSetMouseCursor(InputConfig, Changes);
 			}
 		}
 		case ECTRLInputMode::UIOnly:
 		{
 			if (!InputConfig.bOverrideInputModeDefault)
 			{
-				UWidgetBlueprintLibrary::SetInputMode_UIOnlyEx(PC, InputConfig.WidgetToFocus, InputConfig.MouseLockMode, InputConfig.bFlushInput);
+				if (bSetInputMode)
+				{
+					UWidgetBlueprintLibrary::SetInputMode_UIOnlyEx(PC, InputConfig.WidgetToFocus, InputConfig.MouseLockMode, InputConfig.bFlushInput);
+					CountSetterCalls();
+				}
 			}
 			else
 			{
-				InternalSetMouseCursor(InputConfig);
+				InternalSetMouseCursor(InputConfig, Changes);
 			}
 			break;
 		}
@@ -360,6 +693,7 @@ void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid
 		{
 			bIsIgnoringLookInput = bIgnoreLookInput;
 			PC->SetIgnoreLookInput(bIsIgnoringLookInput);
+			CountSetterCalls();
 		}
 	}
 
@@ -370,20 +704,30 @@ void UCTRLChangeInputConfigSubsystem::ApplyInputConfigFromHandle(TOptional<FGuid
 		{
 			bIsIgnoringMoveInput = bIgnoreMoveInput;
 			PC->SetIgnoreMoveInput(bIsIgnoringMoveInput);
+			CountSetterCalls();
 		}
 	}
-	if (InputConfig.InputMode == ECTRLInputMode::UIOnly && !InputConfig.OverridesIgnoreLookInput() && !InputConfig.OverrideIgnoreMoveInput())
+	if (InputConfig.InputMode == ECTRLInputMode::UIOnly && !InputConfig.OverridesIgnoreLookInput() && !InputConfig.OverrideIgnoreMoveInput()
+		&& HasChanged(Changes, ECTRLInputConfigChange::InputMode | ECTRLInputConfigChange::IgnoreMoveInput | ECTRLInputConfigChange::IgnoreLookInput))
 	{
-		auto const GameViewportClient = LocalPlayer->ViewportClient;
-		GameViewportClient->SetIgnoreInput(true);
+		if (auto const GameViewportClient = LocalPlayer->ViewportClient)
+		{
+			GameViewportClient->SetIgnoreInput(true);
+			CountSetterCalls();
+		}
 	}
+	AppliedInputConfig = PackedInputConfig;
 	// prevent reporting as enqueued
 	// EnqueuedInputConfigs.Remove(InputConfigHandle.GetValue());
 }
 
 void UCTRLChangeInputConfigSubsystem::Update()
 {
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_InputConfigApply);
+	bUpdatePending = false;
 	auto const PreviousInputConfigHandle = CurrentInputConfigHandle;
+	CompactInputConfigHandleStack();
+	EnqueuedInputConfigs.RemoveAll([this](FCTRLInputConfigHandle const& InputConfigHandle) { return !IsHandleValid(InputConfigHandle); });
 	ApplyInputConfigFromHandle(PeekInputConfigStack());
 	ensure(CurrentInputConfigHandle == PeekInputConfigStack());
 
@@ -392,7 +736,126 @@ void UCTRLChangeInputConfigSubsystem::Update()
 	EnqueuedInputConfigs.Reset();
 	for (auto const InputConfigHandle : CurrentEnqueuedInputConfigs)
 	{
-		ensure(GetInputConfig(InputConfigHandle).IsSet());
-		OnInputConfigEnqueued.Broadcast(InputConfigHandle);
+		// a listener may pop configs
+		if (!IsHandleValid(InputConfigHandle)) continue;
+		OnInputConfigEnqueued.Broadcast(InputConfigSlots[InputConfigHandle.Index].Guid);
+	}
+}
+
+namespace CTRL::ChangeInputConfig::Private
+{
+	UCTRLChangeInputConfigSubsystem* GetConsoleSubsystem(UWorld* World)
+	{
+		auto const Subsystem = IsValid(World) ? UCTRLChangeInputConfigSubsystem::Get(World->GetFirstPlayerController()) : nullptr;
+		CICS_CLOG(!Subsystem, Error, TEXT("No input config subsystem, needs a world with a local player controller"));
+		return Subsystem;
+	}
+
+	// Cycles through the input modes & cursor options, so every apply has something to change.
+	// UIOnly is left out, it makes the viewport ignore input
+	FCTRLInputModeConfig MakeBenchmarkInputConfig(int32 const Index)
+	{
+		FCTRLInputModeConfig InputConfig;
+		InputConfig.InputMode = Index % 2 ? ECTRLInputMode::GameAndUI : ECTRLInputMode::GameOnly;
+		InputConfig.bFlushInput = false;
+		InputConfig.bOverrideInputModeDefault = Index % 3 == 0;
+		InputConfig.bShowMouseCursor = Index % 4 < 2;
+		InputConfig.bOverrideMouseCursor = Index % 5 == 0;
+		InputConfig.MouseCursor = static_cast<ECTRLMouseCursor>(Index % static_cast<int32>(ECTRLMouseCursor::Custom));
+		InputConfig.bOverrideMouseLock = Index % 7 == 0;
+		InputConfig.MouseLockMode = Index % 2 ? EMouseLockMode::DoNotLock : EMouseLockMode::LockOnCapture;
+		return InputConfig;
+	}
+}
+
+namespace CTRL::ChangeInputConfig
+{
+	FBenchmarkResult RunBenchmark(UCTRLChangeInputConfigSubsystem& Subsystem, int32 const NumConfigs)
+	{
+		using namespace Private;
+		TArray<FCTRLInputConfigHandle> Handles;
+		Handles.Reserve(NumConfigs);
+		uint64 const PreviousSetterCalls = NumSetterCalls;
+		double const StartTime = FPlatformTime::Seconds();
+		// every push & pop is applied on its own, like changes made in different frames
+		for (int32 Index = 0; Index < NumConfigs; ++Index)
+		{
+			FCTRLInputConfigBatchScope Batch(&Subsystem);
+			Handles.Add(Subsystem.PushInputConfigHandle(MakeBenchmarkInputConfig(Index)));
+		}
+		// pop from the middle, to leave popped handles in the stack & refold the configs above them
+		while (!Handles.IsEmpty())
+		{
+			FCTRLInputConfigBatchScope Batch(&Subsystem);
+			int32 const Index = Handles.Num() / 2;
+			Subsystem.PopInputConfig(Handles[Index]);
+			Handles.RemoveAt(Index, EAllowShrinking::No);
+		}
+		double const Seconds = FPlatformTime::Seconds() - StartTime;
+		int32 const NumOperations = NumConfigs * 2;
+		uint64 const SetterCalls = NumSetterCalls - PreviousSetterCalls;
+		FBenchmarkResult Result;
+		Result.NumOperations = NumOperations;
+		Result.MicrosecondsPerOperation = Seconds * 1000000. / NumOperations;
+		Result.SetterCallsPerOperation = static_cast<double>(SetterCalls) / NumOperations;
+		ULocalPlayer const* LocalPlayer = Subsystem.GetLocalPlayer();
+		Result.bMeasuredSlate = LocalPlayer && LocalPlayer->ViewportClient && LocalPlayer->ViewportClient->GetGameViewportWidget().IsValid();
+		CICS_LOG(
+			Display,
+			TEXT("Benchmark %d configs: %d push/pop, %.3f us per op, %llu setter calls (%.2f per op)%s"),
+			NumConfigs,
+			NumOperations,
+			Result.MicrosecondsPerOperation,
+			SetterCalls,
+			Result.SetterCallsPerOperation,
+			Result.bMeasuredSlate ? TEXT("") : TEXT(", Slate calls not measured (no viewport widget)")
+		);
+		return Result;
 	}
 }
+
+namespace CTRL::ChangeInputConfig::Private
+{
+	FAutoConsoleCommandWithWorldAndArgs BenchmarkCommand(
+		TEXT("CTRL.InputConfig.Benchmark"),
+		TEXT("Pushes then pops N input configs on the first local player, applying each change, and logs the time & Slate/viewport/player controller setter calls per operation. Arguments: config counts, defaults to 10 100 1000."),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateLambda(
+			[](TArray<FString> const& Args, UWorld* World)
+			{
+				auto const Subsystem = GetConsoleSubsystem(World);
+				if (!Subsystem) return;
+				TArray<int32> ConfigCounts;
+				for (FString const& Arg : Args)
+				{
+					ConfigCounts.Add(FMath::Max(1, FCString::Atoi(*Arg)));
+				}
+				if (ConfigCounts.IsEmpty())
+				{
+					ConfigCounts = {10, 100, 1000};
+				}
+				for (int32 const NumConfigs : ConfigCounts)
+				{
+					RunBenchmark(*Subsystem, NumConfigs);
+				}
+			}
+		)
+	);
+
+	FAutoConsoleCommandWithWorld DumpCommand(
+		TEXT("CTRL.InputConfig.Dump"),
+		TEXT("Logs the input config stack of the first local player, bottom first, and the config built from it."),
+		FConsoleCommandWithWorldDelegate::CreateLambda(
+			[](UWorld* World)
+			{
+				auto const Subsystem = GetConsoleSubsystem(World);
+				if (!Subsystem) return;
+				for (FCTRLInputConfigHandle const& InputConfigHandle : Subsystem->InputConfigHandleStack)
+				{
+					TOptional<FCTRLInputModeConfig> const InputConfig = Subsystem->FindInputConfig(InputConfigHandle);
+					CICS_LOG(Display, TEXT("%s %s"), *Subsystem->DescribeHandle(InputConfigHandle), InputConfig.IsSet() ? *InputConfig->ToString() : TEXT("(popped)"));
+				}
+				CICS_LOG(Display, TEXT("Effective: %s"), *Subsystem->GetInputConfigFromStack().ToString());
+			}
+		)
+	);
+}
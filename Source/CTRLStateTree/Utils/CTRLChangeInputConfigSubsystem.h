@@ -7,7 +7,6 @@
 #include "CommonActivatableWidget.h"
 
 #include "Engine/EngineBaseTypes.h"
-#include "Engine/TimerHandle.h"
 
 #include "GenericPlatform/ICursor.h"
 
@@ -15,6 +14,8 @@
 
 #include "Subsystems/LocalPlayerSubsystem.h"
 
+#include "Tickable.h"
+
 #include "Templates/TypeHash.h"
 
 #include "CTRLChangeInputConfigSubsystem.generated.h"
@@ -387,11 +388,134 @@ public:
 	FCTRLInputModeConfig InputConfig;
 };
 
+/*
+ * Fields of the effective input config that differ from the last applied one.
+ * Only the setters for the changed fields are called when applying.
+ */
+enum class ECTRLInputConfigChange : uint8
+{
+	None = 0,
+	// InputMode or bOverrideInputModeDefault
+	InputMode = 1 << 0,
+	IgnoreMoveInput = 1 << 1,
+	IgnoreLookInput = 1 << 2,
+	ShowMouseCursor = 1 << 3,
+	MouseCursor = 1 << 4,
+	MouseLock = 1 << 5,
+	MouseCapture = 1 << 6,
+	WidgetToFocus = 1 << 7,
+	All = 0xFF
+};
+ENUM_CLASS_FLAGS(ECTRLInputConfigChange)
+
+/*
+ * Runtime form of FCTRLInputModeConfig: every field packed into one bitfield, plus a mask of the fields
+ * the config sets when folded onto the configs below it in the stack.
+ * Folding, comparing & diffing are a few bitwise ops.
+ */
+USTRUCT()
+struct CTRLSTATETREE_API FCTRLPackedInputModeConfig
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere)
+	uint32 Values = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	uint32 Overrides = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	TObjectPtr<UUserWidget> WidgetToFocus = nullptr;
+
+	static FCTRLPackedInputModeConfig Pack(FCTRLInputModeConfig const& InputConfig);
+	FCTRLInputModeConfig Unpack() const;
+
+	// Applies the overridden fields of InputConfig, see UCTRLChangeInputConfigSubsystem::GetInputConfigFromStack
+	void Fold(FCTRLPackedInputModeConfig const& InputConfig);
+	ECTRLInputConfigChange Diff(FCTRLPackedInputModeConfig const& InputConfig) const;
+
+	friend bool operator==(FCTRLPackedInputModeConfig const& Lhs, FCTRLPackedInputModeConfig const& RHS)
+	{
+		return Lhs.Values == RHS.Values && Lhs.Overrides == RHS.Overrides && Lhs.WidgetToFocus == RHS.WidgetToFocus;
+	}
+
+	friend bool operator!=(FCTRLPackedInputModeConfig const& Lhs, FCTRLPackedInputModeConfig const& RHS) { return !(Lhs == RHS); }
+
+	friend uint32 GetTypeHash(FCTRLPackedInputModeConfig const& Arg)
+	{
+		return HashCombine(HashCombine(Arg.Values, Arg.Overrides), GetTypeHash(Arg.WidgetToFocus));
+	}
+};
+
+/*
+ * Handle to an input config pushed onto UCTRLChangeInputConfigSubsystem.
+ * Slot index + generation: the handle of a popped config never matches the config that reuses its slot.
+ */
+USTRUCT(BlueprintType)
+struct CTRLSTATETREE_API FCTRLInputConfigHandle
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Index = INDEX_NONE;
+
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+	int32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	// Adapter for FGuid based callers, round-trips through FromGuid
+	FGuid ToGuid() const;
+	// Invalid handle if Guid wasn't created by ToGuid
+	static FCTRLInputConfigHandle FromGuid(FGuid const& Guid);
+
+	FString ToString() const { return FString::Printf(TEXT("%d.%d"), Index, Generation); }
+
+	friend bool operator==(FCTRLInputConfigHandle const& Lhs, FCTRLInputConfigHandle const& RHS)
+	{
+		return Lhs.Index == RHS.Index && Lhs.Generation == RHS.Generation;
+	}
+
+	friend bool operator!=(FCTRLInputConfigHandle const& Lhs, FCTRLInputConfigHandle const& RHS) { return !(Lhs == RHS); }
+
+	friend uint32 GetTypeHash(FCTRLInputConfigHandle const& Arg)
+	{
+		return HashCombine(GetTypeHash(Arg.Index), GetTypeHash(Arg.Generation));
+	}
+};
+
+USTRUCT()
+struct CTRLSTATETREE_API FCTRLInputConfigSlot
+{
+	GENERATED_BODY()
+
+	// Packed once on push, the config is only unpacked for the FCTRLInputModeConfig getters
+	UPROPERTY(VisibleAnywhere)
+	FCTRLPackedInputModeConfig PackedInputConfig;
+
+	// Guid handed out for this config: caller provided, or the handle's ToGuid
+	UPROPERTY(VisibleAnywhere)
+	FGuid Guid;
+
+	// Bumped when the slot is freed
+	UPROPERTY(VisibleAnywhere)
+	int32 Generation = 0;
+
+	UPROPERTY(VisibleAnywhere)
+	bool bInUse = false;
+
+	// Position in InputConfigHandleStack, while in use
+	UPROPERTY(VisibleAnywhere)
+	int32 StackIndex = INDEX_NONE;
+};
+
 /*
  * Manages a stack of input configs for a player controller.
+ * Pushes & pops are applied once, at the end of the frame they were made in (after the tick groups),
+ * or at the end of the outermost BeginBatch/EndBatch.
  */
 UCLASS(BlueprintType, DisplayName="Input Config Subsystem [CTRL]")
-class CTRLSTATETREE_API UCTRLChangeInputConfigSubsystem : public ULocalPlayerSubsystem
+class CTRLSTATETREE_API UCTRLChangeInputConfigSubsystem : public ULocalPlayerSubsystem, public FTickableGameObject
 {
 	GENERATED_BODY()
 
@@ -399,18 +523,34 @@ public:
 	static UCTRLChangeInputConfigSubsystem* Get(ULocalPlayer const* LocalPlayer);
 	static UCTRLChangeInputConfigSubsystem* Get(APlayerController const* PC);
 
+	// Top is last. Popped handles below the top are skipped, and dropped on the next update
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
-	TArray<FGuid> InputConfigHandleStack;
+	TArray<FCTRLInputConfigHandle> InputConfigHandleStack;
 
-	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
-	TMap<FGuid, FCTRLInputModeConfig> InputConfigs;
+	// Dense, popped slots are reused through FreeInputConfigSlots, so it only grows to the most configs pushed at once
+	UPROPERTY(VisibleAnywhere)
+	TArray<FCTRLInputConfigSlot> InputConfigSlots;
+
+	TArray<int32> FreeInputConfigSlots;
+
+	// Popped handles still in InputConfigHandleStack
+	int32 NumStaleInputConfigHandles = 0;
+
+	// FoldedInputConfigStack[i] is the config built from InputConfigHandleStack[0..i], see GetInputConfigFromStack.
+	// Only the first NumFoldedInputConfigs are up to date, pushing folds one entry, popping refolds the entries above
+	mutable TArray<TOptional<FCTRLPackedInputModeConfig>> FoldedInputConfigStack;
+	mutable int32 NumFoldedInputConfigs = 0;
 
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere)
-	TOptional<FGuid> CurrentInputConfigHandle;
+	TOptional<FCTRLInputConfigHandle> CurrentInputConfigHandle;
 
 	// InputConfigs that were added this tick. Report them as enqueued
 	UPROPERTY(BlueprintReadOnly, VisibleAnywhere, Transient)
-	TSet<FGuid> EnqueuedInputConfigs;
+	TArray<FCTRLInputConfigHandle> EnqueuedInputConfigs;
+
+	// Effective config of the last apply, diffed against the next one
+	UPROPERTY(VisibleAnywhere, Transient)
+	TOptional<FCTRLPackedInputModeConfig> AppliedInputConfig;
 
 	UPROPERTY(BlueprintReadOnly, Transient)
 	bool bIsIgnoringMoveInput = false;
@@ -426,34 +566,109 @@ public:
 
 public:
 	// Push the specified input config onto the stack. Queues an update.
+	FCTRLInputConfigHandle PushInputConfigHandle(FCTRLInputModeConfig const& InputConfig);
+	// Remove the specified input config from the stack. Not really a pop. Queues an update.
+	void PopInputConfig(FCTRLInputConfigHandle const& InputConfigHandle);
+
+	// FGuid adapters of the above
 	FGuid PushInputConfig(FCTRLInputModeConfig const& InputConfig);
+	// Push with a guid created by the caller, e.g. off the game thread where the push itself is deferred.
+	void PushInputConfig(FCTRLInputModeConfig const& InputConfig, FGuid const& InputConfigGuid);
+	void PopInputConfig(FGuid const& InputConfigGuid);
+	// Invalid handle if no pushed config has this guid. Guids created by the caller are searched for in the stack
+	FCTRLInputConfigHandle FindHandle(FGuid const& InputConfigGuid) const;
 
-	// Remove the specified input config from the stack. Not really a pop. Queues an update.
-	void PopInputConfig(FGuid const& InputConfigHandle);
+	// True if the handle's config is still on the stack
+	bool IsHandleValid(FCTRLInputConfigHandle const& InputConfigHandle) const;
+	FCTRLPackedInputModeConfig const* FindPackedInputConfig(FCTRLInputConfigHandle const& InputConfigHandle) const;
+	TOptional<FCTRLInputModeConfig> FindInputConfig(FCTRLInputConfigHandle const& InputConfigHandle) const;
 
 	TOptional<FCTRLInputModeConfig> GetCurrentInputConfig() const;
 
-	TOptional<FCTRLInputModeConfig> GetInputConfig(TOptional<FGuid> const& InputConfigHandle) const;
+	TOptional<FCTRLInputModeConfig> GetInputConfig(TOptional<FGuid> const& InputConfigGuid) const;
 
 	// Peek at the top of the input config stack
-	TOptional<FGuid> PeekInputConfigStack() const;
+	TOptional<FCTRLInputConfigHandle> PeekInputConfigStack() const;
+
+	FString DescribeHandle(TOptional<FCTRLInputConfigHandle> InputConfigHandle) const;
 
-	FString DescribeHandle(TOptional<FGuid> InputConfigHandle) const;
-	FGuid GetNextGuid(FCTRLInputModeConfig const& InputConfig) const;
+	// Defers applying pushes & pops until the matching EndBatch, see FCTRLInputConfigBatchScope
+	void BeginBatch();
+	// Applies the pending changes right away when closing the outermost batch
+	void EndBatch();
+	bool IsBatching() const { return BatchDepth > 0; }
 
 	virtual void Deinitialize() override;
 
+	//~ Begin FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual ETickableTickType GetTickableTickType() const override;
+	virtual bool IsTickable() const override;
+	// pause menus push input configs
+	virtual bool IsTickableWhenPaused() const override { return true; }
+	virtual UWorld* GetTickableGameObjectWorld() const override { return GetWorld(); }
+	virtual TStatId GetStatId() const override;
+	//~ End FTickableGameObject
+
 	// Builds the input config from the stack
 	// e.g.
 	// if the stack is {A, B, C}
 	// if A & C set a Mouse Cursor, but B does not, when C is removed, A's MouseCursor is inherited
 	// (otherwise, the cursor set in C would stay)
 	FCTRLInputModeConfig GetInputConfigFromStack() const;
+	TOptional<FCTRLPackedInputModeConfig> GetPackedInputConfigFromStack() const;
 
 protected:
-	FTimerHandle ScheduledUpdateHandle;
+	bool bUpdatePending = false;
+	int32 BatchDepth = 0;
+	// Flags an update for the end of the frame
 	void ScheduleUpdate();
 	void Update();
-	void ApplyInputConfigFromHandle(TOptional<FGuid> InputConfigHandle);
-	void InternalSetMouseCursor(FCTRLInputModeConfig const& InputConfig) const;
+	void ApplyInputConfigFromHandle(TOptional<FCTRLInputConfigHandle> InputConfigHandle);
+	FCTRLInputConfigHandle AddInputConfig(FCTRLInputModeConfig const& InputConfig, FGuid const& InputConfigGuid);
+	// Drops popped handles from the top of the stack
+	void TrimInputConfigHandleStack();
+	// Drops all popped handles from the stack, keeping the folded configs below them
+	void CompactInputConfigHandleStack();
+	void InternalSetMouseCursor(FCTRLInputModeConfig const& InputConfig, ECTRLInputConfigChange Changes) const;
+	static ECTRLInputConfigChange DiffInputConfig(TOptional<FCTRLPackedInputModeConfig> const& PreviousInputConfig, FCTRLPackedInputModeConfig const& InputConfig);
 };
+
+/*
+ * Applies the input config pushes & pops made in its scope once, when it ends.
+ */
+struct CTRLSTATETREE_API FCTRLInputConfigBatchScope
+{
+	explicit FCTRLInputConfigBatchScope(UCTRLChangeInputConfigSubsystem* InSubsystem)
+		: Subsystem(InSubsystem)
+	{
+		if (Subsystem) { Subsystem->BeginBatch(); }
+	}
+
+	~FCTRLInputConfigBatchScope()
+	{
+		if (Subsystem) { Subsystem->EndBatch(); }
+	}
+
+	UE_NONCOPYABLE(FCTRLInputConfigBatchScope);
+
+private:
+	UCTRLChangeInputConfigSubsystem* Subsystem;
+};
+
+namespace CTRL::ChangeInputConfig
+{
+	struct FBenchmarkResult
+	{
+		int32 NumOperations = 0;
+		double MicrosecondsPerOperation = 0.;
+		double SetterCallsPerOperation = 0.;
+		// The local player had a game viewport widget, so the Slate focus & capture calls ran. Without one they're skipped
+		bool bMeasuredSlate = false;
+	};
+
+	// Pushes NumConfigs configs then pops them from the middle, applying every change on its own.
+	// Used by CTRL.InputConfig.Benchmark and the CTRL.InputConfig.Benchmark automation test, which runs without a viewport
+	// widget and so doesn't measure the Slate calls
+	CTRLSTATETREE_API FBenchmarkResult RunBenchmark(UCTRLChangeInputConfigSubsystem& Subsystem, int32 NumConfigs);
+}
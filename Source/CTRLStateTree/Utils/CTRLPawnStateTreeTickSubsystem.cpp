@@ -0,0 +1,298 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLPawnStateTreeTickSubsystem.h"
+
+#include "StateTree.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLPawnStateTreeSchema.h"
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeGameThreadQueue.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+
+#include "Async/ParallelFor.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLPawnStateTreeTickSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Batched Tick"), STAT_CTRLStateTree_BatchedTick, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Tick Components"), STAT_CTRLStateTree_BatchedTickComponents, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Parallel Tick"), STAT_CTRLStateTree_ParallelTick, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Parallel Tick Game Thread Commands"), STAT_CTRLStateTree_ParallelTickCommands, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Parallel Tick Components"), STAT_CTRLStateTree_ParallelTickComponents, STATGROUP_CTRLStateTree);
+
+void FCTRLPawnStateTreeBatchTickFunction::ExecuteTick(float const DeltaTime, ELevelTick const TickType, ENamedThreads::Type CurrentThread, FGraphEventRef const& MyCompletionGraphEvent)
+{
+	if (Subsystem)
+	{
+		Subsystem->TickComponents(DeltaTime, TickType);
+	}
+}
+
+FString FCTRLPawnStateTreeBatchTickFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("%s[BatchTick]"), *GetNameSafe(Subsystem));
+}
+
+FName FCTRLPawnStateTreeBatchTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return TEXT("CTRLPawnStateTreeBatchTick");
+}
+
+UCTRLPawnStateTreeTickSubsystem* UCTRLPawnStateTreeTickSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLPawnStateTreeTickSubsystem>();
+}
+
+bool UCTRLPawnStateTreeTickSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+	RegisterTickFunction(InWorld);
+}
+
+void UCTRLPawnStateTreeTickSubsystem::RegisterTickFunction(UWorld& InWorld)
+{
+	if (TickFunction.IsTickFunctionRegistered()) { return; }
+	// same defaults as a component tick function
+	TickFunction.TickGroup = TG_DuringPhysics;
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bAllowTickOnDedicatedServer = true;
+	TickFunction.Subsystem = this;
+	TickFunction.RegisterTickFunction(InWorld.PersistentLevel);
+}
+
+void UCTRLPawnStateTreeTickSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+	TickFunction.Subsystem = nullptr;
+	for (FCTRLPawnStateTreeTickGroup& Group : Groups)
+	{
+		for (FCTRLPawnStateTreeTickEntry const& Entry : Group.Entries)
+		{
+			if (IsValid(Entry.Component))
+			{
+				Entry.Component->OnUnregisteredFromBatchedTick(Entry.TickInterval, Entry.bTickEnabled);
+			}
+		}
+	}
+	Groups.Empty();
+	Super::Deinitialize();
+}
+
+bool UCTRLPawnStateTreeTickSubsystem::Register(UCTRLPawnStateTreeComponent* Component)
+{
+	if (!IsValid(Component)) { return false; }
+	UStateTree const* StateTree = Component->GetStateTreeReference().GetStateTree();
+	if (FindEntry(Component))
+	{
+		if (Groups[Component->BatchedTickGroupIndex].StateTree == StateTree) { return true; }
+		// asset changed, move to the matching group
+		Unregister(Component);
+	}
+
+	if (!TickFunction.IsTickFunctionRegistered())
+	{
+		RegisterTickFunction(*GetWorld());
+	}
+
+	int32 GroupIndex = Groups.IndexOfByPredicate([StateTree](FCTRLPawnStateTreeTickGroup const& Group) { return Group.StateTree == StateTree; });
+	if (GroupIndex == INDEX_NONE)
+	{
+		GroupIndex = Groups.AddDefaulted();
+		FCTRLPawnStateTreeTickGroup& NewGroup = Groups[GroupIndex];
+		NewGroup.StateTree = StateTree;
+		if (StateTree)
+		{
+			TArray<UStateTree const*> LinkedStateTrees;
+			UCTRLPawnStateTreeSchema::GetLinkedStateTrees(*StateTree, LinkedStateTrees);
+			NewGroup.LinkedStateTrees.Append(LinkedStateTrees);
+			NewGroup.bParallelSafe = UCTRLPawnStateTreeSchema::IsStateTreeParallelSafe(*StateTree);
+		}
+	}
+
+	FCTRLPawnStateTreeTickGroup& Group = Groups[GroupIndex];
+	FCTRLPawnStateTreeTickEntry& Entry = Group.Entries.AddDefaulted_GetRef();
+	Entry.Component = Component;
+	Entry.TickInterval = Component->GetComponentTickInterval();
+	Entry.bTickEnabled = Component->IsComponentTickEnabled();
+	Component->BatchedTickGroupIndex = GroupIndex;
+	Component->BatchedTickEntryIndex = Group.Entries.Num() - 1;
+	Component->SetComponentTickEnabled(false);
+	return true;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::Unregister(UCTRLPawnStateTreeComponent* Component)
+{
+	FCTRLPawnStateTreeTickEntry* Entry = FindEntry(Component);
+	if (!Entry) { return; }
+	Groups[Component->BatchedTickGroupIndex].bHasStaleEntries = true;
+	Entry->Component = nullptr;
+	Component->BatchedTickGroupIndex = INDEX_NONE;
+	Component->BatchedTickEntryIndex = INDEX_NONE;
+	Component->OnUnregisteredFromBatchedTick(Entry->TickInterval, Entry->bTickEnabled);
+	if (!bIsTicking)
+	{
+		RemoveStaleEntries();
+	}
+}
+
+FCTRLPawnStateTreeTickEntry* UCTRLPawnStateTreeTickSubsystem::FindEntry(UCTRLPawnStateTreeComponent const* Component)
+{
+	return const_cast<FCTRLPawnStateTreeTickEntry*>(const_cast<UCTRLPawnStateTreeTickSubsystem const*>(this)->FindEntry(Component));
+}
+
+FCTRLPawnStateTreeTickEntry const* UCTRLPawnStateTreeTickSubsystem::FindEntry(UCTRLPawnStateTreeComponent const* Component) const
+{
+	if (!Component || !Groups.IsValidIndex(Component->BatchedTickGroupIndex)) { return nullptr; }
+	FCTRLPawnStateTreeTickGroup const& Group = Groups[Component->BatchedTickGroupIndex];
+	if (!Group.Entries.IsValidIndex(Component->BatchedTickEntryIndex)) { return nullptr; }
+	FCTRLPawnStateTreeTickEntry const& Entry = Group.Entries[Component->BatchedTickEntryIndex];
+	return Entry.Component == Component ? &Entry : nullptr;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::SetTickEnabled(UCTRLPawnStateTreeComponent const* Component, bool const bEnabled)
+{
+	if (FCTRLPawnStateTreeTickEntry* Entry = FindEntry(Component))
+	{
+		Entry->bTickEnabled = bEnabled;
+		Entry->AccumulatedDeltaTime = 0.f;
+	}
+}
+
+bool UCTRLPawnStateTreeTickSubsystem::IsTickEnabled(UCTRLPawnStateTreeComponent const* Component) const
+{
+	FCTRLPawnStateTreeTickEntry const* Entry = FindEntry(Component);
+	return Entry && Entry->bTickEnabled;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::SetTickInterval(UCTRLPawnStateTreeComponent const* Component, float const TickInterval)
+{
+	if (FCTRLPawnStateTreeTickEntry* Entry = FindEntry(Component))
+	{
+		Entry->TickInterval = TickInterval;
+	}
+}
+
+float UCTRLPawnStateTreeTickSubsystem::GetTickInterval(UCTRLPawnStateTreeComponent const* Component) const
+{
+	FCTRLPawnStateTreeTickEntry const* Entry = FindEntry(Component);
+	return Entry ? Entry->TickInterval : 0.f;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::TickComponents(float const DeltaTime, ELevelTick const TickType)
+{
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_BatchedTick);
+	TGuardValue<bool> TickingGuard(bIsTicking, true);
+
+	int32 NumTicked = 0;
+	ParallelTickItems.Reset();
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		bool const bParallel = CanTickInParallel(Groups[GroupIndex]);
+		// index based, ticking may register more components and grow the arrays
+		for (int32 EntryIndex = 0; EntryIndex < Groups[GroupIndex].Entries.Num(); ++EntryIndex)
+		{
+			FCTRLPawnStateTreeTickEntry& Entry = Groups[GroupIndex].Entries[EntryIndex];
+			UCTRLPawnStateTreeComponent* Component = Entry.Component;
+			if (!IsValid(Component))
+			{
+				Groups[GroupIndex].bHasStaleEntries = true;
+				continue;
+			}
+			if (!Entry.bTickEnabled) { continue; }
+
+			Entry.AccumulatedDeltaTime += DeltaTime;
+			if (Entry.AccumulatedDeltaTime < Entry.TickInterval) { continue; }
+
+			float const ComponentDeltaTime = Entry.AccumulatedDeltaTime;
+			Entry.AccumulatedDeltaTime = 0.f;
+			if (bParallel)
+			{
+				if (Component->PrepareParallelTick(Groups[GroupIndex].LinkedStateTrees))
+				{
+					ParallelTickItems.Add({Component, ComponentDeltaTime});
+				}
+				continue;
+			}
+			Component->TickComponent(ComponentDeltaTime, TickType, nullptr);
+			++NumTicked;
+		}
+	}
+	SET_DWORD_STAT(STAT_CTRLStateTree_BatchedTickComponents, NumTicked);
+
+	TickParallel();
+
+	RemoveStaleEntries();
+}
+
+bool UCTRLPawnStateTreeTickSubsystem::CanTickInParallel(FCTRLPawnStateTreeTickGroup const& Group) const
+{
+	return Group.StateTree && Group.bParallelSafe && UCTRLStateTreeSettings::Get()->bParallelTick;
+}
+
+void UCTRLPawnStateTreeTickSubsystem::TickParallel()
+{
+	SET_DWORD_STAT(STAT_CTRLStateTree_ParallelTickComponents, ParallelTickItems.Num());
+	if (ParallelTickItems.IsEmpty()) { return; }
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_ParallelTick);
+		// each instance only touches its own instance data, everything else is queued for the game thread.
+		// That includes the items ParallelFor runs on the game thread itself
+		CTRL::StateTree::FParallelTickScope ParallelTickScope;
+		ParallelFor(
+			TEXT("CTRLPawnStateTreeParallelTick"),
+			ParallelTickItems.Num(),
+			UCTRLStateTreeSettings::Get()->ParallelTickMinBatchSize,
+			[this](int32 const Index)
+			{
+				FCTRLPawnStateTreeParallelTickItem const& Item = ParallelTickItems[Index];
+				Item.Component->TickStateTreeParallel(Item.DeltaTime);
+			}
+		);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_ParallelTickCommands);
+		CTRL::StateTree::FlushGameThreadCommands();
+	}
+	// sleeping disables the tick, which has to happen on the game thread
+	for (FCTRLPawnStateTreeParallelTickItem const& Item : ParallelTickItems)
+	{
+		if (IsValid(Item.Component))
+		{
+			Item.Component->UpdateSleep();
+		}
+	}
+	ParallelTickItems.Reset();
+}
+
+void UCTRLPawnStateTreeTickSubsystem::RemoveStaleEntries()
+{
+	for (int32 GroupIndex = 0; GroupIndex < Groups.Num(); ++GroupIndex)
+	{
+		FCTRLPawnStateTreeTickGroup& Group = Groups[GroupIndex];
+		if (!Group.bHasStaleEntries) { continue; }
+		Group.bHasStaleEntries = false;
+		// stable, keeps tick order deterministic
+		Group.Entries.RemoveAll([](FCTRLPawnStateTreeTickEntry const& Entry) { return !IsValid(Entry.Component); });
+		for (int32 EntryIndex = 0; EntryIndex < Group.Entries.Num(); ++EntryIndex)
+		{
+			Group.Entries[EntryIndex].Component->BatchedTickEntryIndex = EntryIndex;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Engine/EngineBaseTypes.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CTRLPawnStateTreeTickSubsystem.generated.h"
+
+class UStateTree;
+class UCTRLPawnStateTreeComponent;
+class UCTRLPawnStateTreeTickSubsystem;
+
+// Single tick function that ticks every component registered with UCTRLPawnStateTreeTickSubsystem
+struct FCTRLPawnStateTreeBatchTickFunction : public FTickFunction
+{
+	UCTRLPawnStateTreeTickSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, FGraphEventRef const& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+	virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
+USTRUCT()
+struct FCTRLPawnStateTreeTickEntry
+{
+	GENERATED_BODY()
+
+	// null once unregistered, removed at the end of the batch tick
+	UPROPERTY()
+	TObjectPtr<UCTRLPawnStateTreeComponent> Component = nullptr;
+
+	float TickInterval = 0.f;
+	float AccumulatedDeltaTime = 0.f;
+	bool bTickEnabled = true;
+};
+
+// All registered components running the same StateTree asset, ticked back to back
+USTRUCT()
+struct FCTRLPawnStateTreeTickGroup
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStateTree const> StateTree = nullptr;
+
+	UPROPERTY()
+	TArray<FCTRLPawnStateTreeTickEntry> Entries;
+
+	// Assets linked from StateTree, see UCTRLPawnStateTreeSchema::GetLinkedStateTrees
+	UPROPERTY()
+	TArray<TObjectPtr<UStateTree const>> LinkedStateTrees;
+
+	bool bHasStaleEntries = false;
+	// StateTree and its linked assets are parallel-safe, found when the group was created
+	bool bParallelSafe = false;
+};
+
+// A component due to tick this frame in the parallel phase
+struct FCTRLPawnStateTreeParallelTickItem
+{
+	UCTRLPawnStateTreeComponent* Component = nullptr;
+	float DeltaTime = 0.f;
+};
+
+/*
+ * Ticks all pawn state tree components that opted in via bUseBatchedTick from one tick function,
+ * grouped by StateTree asset, instead of one tick function per component.
+ * Groups tick in the order their asset was first registered, entries in registration order.
+ * A registered component's own tick function is disabled; use UCTRLPawnStateTreeComponent::SetStateTreeTickInterval/Enabled.
+ * Groups whose schema is parallel-safe tick across worker threads after the other groups (see UCTRLStateTreeSettings::bParallelTick),
+ * game thread side effects queued by their tasks run once all workers finished.
+ */
+UCLASS(DisplayName="Pawn StateTree Tick Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLPawnStateTreeTickSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLPawnStateTreeTickSubsystem* Get(UObject const* WorldContextObject);
+
+	bool Register(UCTRLPawnStateTreeComponent* Component);
+	void Unregister(UCTRLPawnStateTreeComponent* Component);
+
+	void SetTickEnabled(UCTRLPawnStateTreeComponent const* Component, bool bEnabled);
+	bool IsTickEnabled(UCTRLPawnStateTreeComponent const* Component) const;
+	void SetTickInterval(UCTRLPawnStateTreeComponent const* Component, float TickInterval);
+	float GetTickInterval(UCTRLPawnStateTreeComponent const* Component) const;
+
+	void TickComponents(float DeltaTime, ELevelTick TickType);
+
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	FCTRLPawnStateTreeTickEntry* FindEntry(UCTRLPawnStateTreeComponent const* Component);
+	FCTRLPawnStateTreeTickEntry const* FindEntry(UCTRLPawnStateTreeComponent const* Component) const;
+	void RegisterTickFunction(UWorld& InWorld);
+	void RemoveStaleEntries();
+	bool CanTickInParallel(FCTRLPawnStateTreeTickGroup const& Group) const;
+	void TickParallel();
+
+	UPROPERTY(Transient)
+	TArray<FCTRLPawnStateTreeTickGroup> Groups;
+
+	FCTRLPawnStateTreeBatchTickFunction TickFunction;
+	TArray<FCTRLPawnStateTreeParallelTickItem> ParallelTickItems;
+	bool bIsTicking = false;
+};
@@ -0,0 +1,338 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeEventRouterSubsystem.h"
+
+#include "AbilitySystemComponent.h"
+#include "GameplayTagsManager.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeEventRouterSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Gameplay Event Dispatch"), STAT_CTRLStateTree_GameplayEventDispatch, STATGROUP_CTRLStateTree);
+DECLARE_CYCLE_STAT(TEXT("Coalesced Gameplay Event Flush"), STAT_CTRLStateTree_GameplayEventFlush, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Gameplay Event Subscribers"), STAT_CTRLStateTree_GameplayEventSubscribers, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Merged Gameplay Events"), STAT_CTRLStateTree_MergedGameplayEvents, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeEventRouterSubsystem* UCTRLStateTreeEventRouterSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeEventRouterSubsystem>();
+}
+
+bool UCTRLStateTreeEventRouterSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UCTRLStateTreeEventRouterSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCTRLStateTreeEventRouterSubsystem, STATGROUP_CTRLStateTree);
+}
+
+void UCTRLStateTreeEventRouterSubsystem::Deinitialize()
+{
+	for (TPair<TObjectKey<UAbilitySystemComponent>, FCTRLGameplayEventRouter> const& Pair : Routers)
+	{
+		if (UAbilitySystemComponent* AbilitySystem = Pair.Value.AbilitySystem.Get())
+		{
+			AbilitySystem->RemoveGameplayEventTagContainerDelegate(FGameplayTagContainer(), Pair.Value.DelegateHandle);
+		}
+	}
+	Routers.Empty();
+	TaggedPayload = FGameplayEventData();
+	PendingEvents.Empty();
+	FlushedEvents.Empty();
+	PendingEventIndices.Empty();
+	Subscribers.Empty();
+	FreeSubscribers.Empty();
+	PendingFreeSubscribers.Empty();
+	Super::Deinitialize();
+}
+
+FCTRLGameplayEventSubscription UCTRLStateTreeEventRouterSubsystem::Subscribe(
+	UAbilitySystemComponent& AbilitySystem,
+	FGameplayTagContainer const& EventTags,
+	bool const bOnlyMatchExact,
+	bool const bOnlyTriggerOnce,
+	FCTRLGameplayEventDelegate&& OnEvent,
+	ECTRLGameplayEventCoalescing const Coalescing
+)
+{
+	TObjectKey<UAbilitySystemComponent> const AbilitySystemKey(&AbilitySystem);
+	FCTRLGameplayEventRouter& Router = Routers.FindOrAdd(AbilitySystemKey);
+	if (!Router.DelegateHandle.IsValid())
+	{
+		// an empty filter matches every event
+		Router.AbilitySystem = &AbilitySystem;
+		Router.DelegateHandle = AbilitySystem.AddGameplayEventTagContainerDelegate(
+			FGameplayTagContainer(),
+			FGameplayEventTagMulticastDelegate::FDelegate::CreateUObject(this, &ThisClass::HandleGameplayEvent, AbilitySystemKey)
+		);
+	}
+
+	VerifyTagMasks();
+	int32 GroupIndex = Router.Groups.IndexOfByPredicate(
+		[&EventTags, bOnlyMatchExact](FCTRLGameplayEventSubscriberGroup const& Group)
+		{
+			return !Group.IsEmpty() && Group.bOnlyMatchExact == bOnlyMatchExact && Group.EventTags == EventTags;
+		}
+	);
+	if (GroupIndex == INDEX_NONE)
+	{
+		GroupIndex = Router.Groups.IndexOfByPredicate([](FCTRLGameplayEventSubscriberGroup const& Group) { return Group.IsEmpty(); });
+		if (GroupIndex == INDEX_NONE)
+		{
+			GroupIndex = Router.Groups.AddDefaulted();
+		}
+		FCTRLGameplayEventSubscriberGroup& Group = Router.Groups[GroupIndex];
+		Group.EventTags = EventTags;
+		Group.bOnlyMatchExact = bOnlyMatchExact;
+		CompileTagMask(Group);
+		Router.TagMask.CombineWithBitwiseOR(Group.TagMask, EBitwiseOperatorFlags::MaxSize);
+	}
+
+	int32 const Index = FreeSubscribers.IsEmpty() ? Subscribers.AddDefaulted() : FreeSubscribers.Pop(EAllowShrinking::No);
+	FCTRLGameplayEventSubscriber& Subscriber = Subscribers[Index];
+	Subscriber.AbilitySystem = AbilitySystemKey;
+	Subscriber.OnEvent = MoveTemp(OnEvent);
+	Subscriber.GroupIndex = GroupIndex;
+	// a once only subscription is gone by the end of the frame
+	Subscriber.Coalescing = bOnlyTriggerOnce ? ECTRLGameplayEventCoalescing::None : Coalescing;
+	Subscriber.bOnlyTriggerOnce = bOnlyTriggerOnce;
+	Subscriber.bInUse = true;
+
+	FCTRLGameplayEventSubscription const Subscription{Index, Subscriber.Generation};
+	Router.Groups[GroupIndex].Subscriptions.Add(Subscription);
+	++Router.NumSubscribers;
+	INC_DWORD_STAT(STAT_CTRLStateTree_GameplayEventSubscribers);
+	return Subscription;
+}
+
+bool UCTRLStateTreeEventRouterSubsystem::IsSubscribed(FCTRLGameplayEventSubscription const& Subscription) const
+{
+	if (!Subscribers.IsValidIndex(Subscription.Index)) { return false; }
+	FCTRLGameplayEventSubscriber const& Subscriber = Subscribers[Subscription.Index];
+	return Subscriber.bInUse && Subscriber.Generation == Subscription.Generation;
+}
+
+void UCTRLStateTreeEventRouterSubsystem::Unsubscribe(FCTRLGameplayEventSubscription& Subscription)
+{
+	ON_SCOPE_EXIT
+	{
+		Subscription = FCTRLGameplayEventSubscription();
+	};
+	if (!IsSubscribed(Subscription)) { return; }
+
+	FCTRLGameplayEventSubscriber& Subscriber = Subscribers[Subscription.Index];
+	Subscriber.bInUse = false;
+	++Subscriber.Generation;
+	DEC_DWORD_STAT(STAT_CTRLStateTree_GameplayEventSubscribers);
+	if (FCTRLGameplayEventRouter* Router = Routers.Find(Subscriber.AbilitySystem))
+	{
+		if (--Router->NumSubscribers <= 0)
+		{
+			if (UAbilitySystemComponent* AbilitySystem = Router->AbilitySystem.Get())
+			{
+				AbilitySystem->RemoveGameplayEventTagContainerDelegate(FGameplayTagContainer(), Router->DelegateHandle);
+			}
+			Routers.Remove(Subscriber.AbilitySystem);
+		}
+		else if (Router->Groups.IsValidIndex(Subscriber.GroupIndex))
+		{
+			FCTRLGameplayEventSubscriberGroup& Group = Router->Groups[Subscriber.GroupIndex];
+			Group.Subscriptions.RemoveSingleSwap(Subscription, EAllowShrinking::No);
+			if (Group.IsEmpty())
+			{
+				// keeps the mask allocation for the next group using this slot
+				Group.EventTags.Reset();
+				Group.TagMask.Reset();
+				CompileTagMask(*Router);
+			}
+		}
+	}
+
+	if (DispatchDepth > 0)
+	{
+		PendingFreeSubscribers.Add(Subscription.Index);
+		return;
+	}
+	FreeSubscriber(Subscription.Index);
+}
+
+void UCTRLStateTreeEventRouterSubsystem::FreeSubscriber(int32 const Index)
+{
+	FCTRLGameplayEventSubscriber& Subscriber = Subscribers[Index];
+	Subscriber.OnEvent.Unbind();
+	Subscriber.GroupIndex = INDEX_NONE;
+	Subscriber.Coalescing = ECTRLGameplayEventCoalescing::None;
+	FreeSubscribers.Push(Index);
+}
+
+void UCTRLStateTreeEventRouterSubsystem::VerifyTagMasks()
+{
+	uint32 const Hash = UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndexHash();
+	if (Hash == TagMaskHash) { return; }
+	TagMaskHash = Hash;
+	for (TPair<TObjectKey<UAbilitySystemComponent>, FCTRLGameplayEventRouter>& Pair : Routers)
+	{
+		for (FCTRLGameplayEventSubscriberGroup& Group : Pair.Value.Groups)
+		{
+			if (Group.IsEmpty()) { continue; }
+			CompileTagMask(Group);
+		}
+		CompileTagMask(Pair.Value);
+	}
+}
+
+void UCTRLStateTreeEventRouterSubsystem::CompileTagMask(FCTRLGameplayEventSubscriberGroup& Group)
+{
+	UGameplayTagsManager const& TagsManager = UGameplayTagsManager::Get();
+	Group.TagMask.Init(false, TagsManager.GetNetworkGameplayTagNodeIndex().Num());
+	auto SetTag = [&Group, &TagsManager](FGameplayTag const& Tag)
+	{
+		int32 const NetIndex = TagsManager.GetNetIndexFromTag(Tag);
+		if (!Group.TagMask.IsValidIndex(NetIndex)) { return; }
+		Group.TagMask[NetIndex] = true;
+	};
+	for (FGameplayTag const& EventTag : Group.EventTags)
+	{
+		if (!EventTag.IsValid()) { continue; }
+		SetTag(EventTag);
+		if (Group.bOnlyMatchExact) { continue; }
+		// a parent tag matches events sent with any of its children
+		for (FGameplayTag const& ChildTag : TagsManager.RequestGameplayTagChildren(EventTag))
+		{
+			SetTag(ChildTag);
+		}
+	}
+}
+
+void UCTRLStateTreeEventRouterSubsystem::CompileTagMask(FCTRLGameplayEventRouter& Router)
+{
+	Router.TagMask.Init(false, UGameplayTagsManager::Get().GetNetworkGameplayTagNodeIndex().Num());
+	for (FCTRLGameplayEventSubscriberGroup const& Group : Router.Groups)
+	{
+		if (Group.IsEmpty()) { continue; }
+		Router.TagMask.CombineWithBitwiseOR(Group.TagMask, EBitwiseOperatorFlags::MaxSize);
+	}
+}
+
+void UCTRLStateTreeEventRouterSubsystem::HandleGameplayEvent(
+	FGameplayTag const EventTag,
+	FGameplayEventData const* Payload,
+	TObjectKey<UAbilitySystemComponent> const AbilitySystemKey
+)
+{
+	if (!Payload || !EventTag.IsValid()) { return; }
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_GameplayEventDispatch);
+	VerifyTagMasks();
+	FCTRLGameplayEventRouter* Router = Routers.Find(AbilitySystemKey);
+	if (!Router) { return; }
+
+	int32 const NetIndex = UGameplayTagsManager::Get().GetNetIndexFromTag(EventTag);
+	if (!Router->TagMask.IsValidIndex(NetIndex) || !Router->TagMask[NetIndex]) { return; }
+
+	// collected up front, subscribers may (un)subscribe while the event is dispatched
+	TArray<FCTRLGameplayEventSubscription, TInlineAllocator<16>> Matches;
+	for (FCTRLGameplayEventSubscriberGroup const& Group : Router->Groups)
+	{
+		if (!Group.TagMask.IsValidIndex(NetIndex) || !Group.TagMask[NetIndex]) { continue; }
+		Matches.Append(Group.Subscriptions);
+	}
+	if (Matches.IsEmpty()) { return; }
+
+	// the ASC passes the event tag separately, only copy when the payload doesn't carry it
+	FGameplayEventData const* EventPayload = Payload;
+	TOptional<FGameplayEventData> NestedTaggedPayload;
+	if (Payload->EventTag != EventTag)
+	{
+		// an event sent from a subscriber would overwrite TaggedPayload
+		FGameplayEventData& Tagged = DispatchDepth == 0 ? TaggedPayload : NestedTaggedPayload.Emplace();
+		Tagged = *Payload;
+		Tagged.EventTag = EventTag;
+		EventPayload = &Tagged;
+	}
+
+	++DispatchDepth;
+	for (FCTRLGameplayEventSubscription Subscription : Matches)
+	{
+		// unsubscribed by an earlier subscriber
+		if (!IsSubscribed(Subscription)) { continue; }
+		FCTRLGameplayEventSubscriber const& Subscriber = Subscribers[Subscription.Index];
+		if (Subscriber.Coalescing != ECTRLGameplayEventCoalescing::None)
+		{
+			CoalesceEvent(Subscription, Subscriber.Coalescing, EventTag, *EventPayload);
+			continue;
+		}
+		bool const bOnlyTriggerOnce = Subscriber.bOnlyTriggerOnce;
+		Subscriber.OnEvent.ExecuteIfBound(EventTag, *EventPayload);
+		if (bOnlyTriggerOnce)
+		{
+			Unsubscribe(Subscription);
+		}
+	}
+	EndDispatch();
+}
+
+void UCTRLStateTreeEventRouterSubsystem::EndDispatch()
+{
+	if (--DispatchDepth > 0) { return; }
+	for (int32 const Index : PendingFreeSubscribers)
+	{
+		FreeSubscriber(Index);
+	}
+	PendingFreeSubscribers.Reset();
+}
+
+void UCTRLStateTreeEventRouterSubsystem::CoalesceEvent(
+	FCTRLGameplayEventSubscription const Subscription,
+	ECTRLGameplayEventCoalescing const Coalescing,
+	FGameplayTag const EventTag,
+	FGameplayEventData const& Payload
+)
+{
+	if (int32 const* PendingIndex = PendingEventIndices.Find({Subscription.Index, EventTag}))
+	{
+		FCTRLPendingGameplayEvent& Pending = PendingEvents[*PendingIndex];
+		// the slot may have been reused by a later subscription
+		if (Pending.Subscription == Subscription)
+		{
+			if (Coalescing == ECTRLGameplayEventCoalescing::KeepLast)
+			{
+				Pending.Payload = Payload;
+			}
+			INC_DWORD_STAT(STAT_CTRLStateTree_MergedGameplayEvents);
+			return;
+		}
+	}
+
+	PendingEventIndices.Add({Subscription.Index, EventTag}, PendingEvents.Num());
+	FCTRLPendingGameplayEvent& Pending = PendingEvents.AddDefaulted_GetRef();
+	Pending.Subscription = Subscription;
+	Pending.EventTag = EventTag;
+	Pending.Payload = Payload;
+}
+
+void UCTRLStateTreeEventRouterSubsystem::Tick(float const DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_GameplayEventFlush);
+
+	Swap(PendingEvents, FlushedEvents);
+	PendingEventIndices.Reset();
+	++DispatchDepth;
+	for (FCTRLPendingGameplayEvent const& Pending : FlushedEvents)
+	{
+		// unsubscribed since, e.g. the state was exited
+		if (!IsSubscribed(Pending.Subscription)) { continue; }
+		Subscribers[Pending.Subscription.Index].OnEvent.ExecuteIfBound(Pending.EventTag, Pending.Payload);
+	}
+	EndDispatch();
+	FlushedEvents.Reset();
+}
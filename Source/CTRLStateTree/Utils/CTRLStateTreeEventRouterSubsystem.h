@@ -0,0 +1,159 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+#include "Abilities/GameplayAbilityTypes.h"
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "CTRLStateTreeEventRouterSubsystem.generated.h"
+
+class UAbilitySystemComponent;
+
+// Handle to a subscription made with UCTRLStateTreeEventRouterSubsystem::Subscribe
+struct CTRLSTATETREE_API FCTRLGameplayEventSubscription
+{
+	int32 Index = INDEX_NONE;
+	int32 Generation = 0;
+
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	friend bool operator==(FCTRLGameplayEventSubscription const& Lhs, FCTRLGameplayEventSubscription const& RHS)
+	{
+		return Lhs.Index == RHS.Index && Lhs.Generation == RHS.Generation;
+	}
+};
+
+// How events of the same tag received by a subscriber within a frame are delivered
+UENUM(BlueprintType)
+enum class ECTRLGameplayEventCoalescing : uint8
+{
+	// Deliver every event as it is received
+	None,
+	// Deliver one event per tag at the end of the frame, with the payload of the first event received
+	KeepFirst,
+	// Deliver one event per tag at the end of the frame, with the payload of the last event received
+	KeepLast,
+};
+
+// Payload is only valid for the duration of the call
+DECLARE_DELEGATE_TwoParams(FCTRLGameplayEventDelegate, FGameplayTag /*EventTag*/, FGameplayEventData const& /*Payload*/);
+
+struct FCTRLGameplayEventSubscriber
+{
+	TObjectKey<UAbilitySystemComponent> AbilitySystem;
+	FCTRLGameplayEventDelegate OnEvent;
+	int32 GroupIndex = INDEX_NONE;
+	int32 Generation = 0;
+	ECTRLGameplayEventCoalescing Coalescing = ECTRLGameplayEventCoalescing::None;
+	bool bOnlyTriggerOnce = false;
+	bool bInUse = false;
+};
+
+// Subscribers of an ability system component listening to the same tags, in the same match mode
+struct FCTRLGameplayEventSubscriberGroup
+{
+	FGameplayTagContainer EventTags;
+	// Indexed by gameplay tag net index, set for every event tag and (unless bOnlyMatchExact) their children
+	TBitArray<> TagMask;
+	TArray<FCTRLGameplayEventSubscription, TInlineAllocator<4>> Subscriptions;
+	bool bOnlyMatchExact = false;
+
+	bool IsEmpty() const { return Subscriptions.IsEmpty(); }
+};
+
+// Event held back by coalescing until the end of the frame
+struct FCTRLPendingGameplayEvent
+{
+	FCTRLGameplayEventSubscription Subscription;
+	FGameplayTag EventTag;
+	FGameplayEventData Payload;
+};
+
+// Single gameplay event delegate on an ability system component, shared by all its subscribers
+struct FCTRLGameplayEventRouter
+{
+	TWeakObjectPtr<UAbilitySystemComponent> AbilitySystem;
+	FDelegateHandle DelegateHandle;
+	// Empty groups are kept for reuse, subscribers address their group by index
+	TArray<FCTRLGameplayEventSubscriberGroup> Groups;
+	// Union of the group masks, rejects events nobody listens to with a single bit test
+	TBitArray<> TagMask;
+	int32 NumSubscribers = 0;
+};
+
+/*
+ * Routes Ability System gameplay events to StateTree tasks (see FCTRLGasEventToStateTreeEventTask).
+ * Registers one delegate per ability system component, so subscribing doesn't allocate a UObject nor add a delegate to the ASC.
+ * Event tags are compiled into bit masks over the gameplay tag net index, so matching an event is a bit test per subscriber group.
+ * Subscribers can coalesce events of the same tag, these are delivered once per frame from the subsystem tick.
+ */
+UCLASS(DisplayName="StateTree Event Router Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeEventRouterSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeEventRouterSubsystem* Get(UObject const* WorldContextObject);
+
+	// OnEvent is called for events matching EventTags: exactly, or as a child tag unless bOnlyMatchExact
+	FCTRLGameplayEventSubscription Subscribe(
+		UAbilitySystemComponent& AbilitySystem,
+		FGameplayTagContainer const& EventTags,
+		bool bOnlyMatchExact,
+		bool bOnlyTriggerOnce,
+		FCTRLGameplayEventDelegate&& OnEvent,
+		ECTRLGameplayEventCoalescing Coalescing = ECTRLGameplayEventCoalescing::None
+	);
+	// Resets Subscription. Safe to call from OnEvent
+	void Unsubscribe(FCTRLGameplayEventSubscription& Subscription);
+	bool IsSubscribed(FCTRLGameplayEventSubscription const& Subscription) const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override { return !PendingEvents.IsEmpty(); }
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	void HandleGameplayEvent(FGameplayTag EventTag, FGameplayEventData const* Payload, TObjectKey<UAbilitySystemComponent> AbilitySystemKey);
+	void FreeSubscriber(int32 Index);
+	// Holds the event back until the end of the frame, merging it with a pending one of the same subscriber & tag
+	void CoalesceEvent(FCTRLGameplayEventSubscription Subscription, ECTRLGameplayEventCoalescing Coalescing, FGameplayTag EventTag, FGameplayEventData const& Payload);
+	// Frees the subscribers unsubscribed while dispatching once the outermost dispatch is done
+	void EndDispatch();
+
+	// Net indices change when the tag tree is rebuilt (e.g. tags added in editor), recompiles every mask if it was
+	void VerifyTagMasks();
+	static void CompileTagMask(FCTRLGameplayEventSubscriberGroup& Group);
+	static void CompileTagMask(FCTRLGameplayEventRouter& Router);
+
+	TMap<TObjectKey<UAbilitySystemComponent>, FCTRLGameplayEventRouter> Routers;
+
+	TArray<FCTRLGameplayEventSubscriber> Subscribers;
+	TArray<int32> FreeSubscribers;
+	// unsubscribed while dispatching, their delegate may be executing
+	TArray<int32> PendingFreeSubscribers;
+	int32 DispatchDepth = 0;
+	// network tag index hash the masks were compiled against
+	uint32 TagMaskHash = 0;
+
+	// Coalesced events, in the order they were first received. Swapped with FlushedEvents on tick, so events sent
+	// while flushing wait for the next frame
+	TArray<FCTRLPendingGameplayEvent> PendingEvents;
+	TArray<FCTRLPendingGameplayEvent> FlushedEvents;
+	// index in PendingEvents per subscriber & tag
+	TMap<TPair<int32, FGameplayTag>, int32> PendingEventIndices;
+
+	// Payload of events whose EventTag isn't the tag they were sent with. Reused, so copying into it
+	// doesn't allocate once its tag containers & target data have grown
+	FGameplayEventData TaggedPayload;
+};
@@ -0,0 +1,122 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeInstanceDataPoolSubsystem.h"
+
+#include "StateTree.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeInstanceDataPoolSubsystem)
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instance Data Pool Hits"), STAT_CTRLStateTree_PoolHits, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instance Data Pool Misses"), STAT_CTRLStateTree_PoolMisses, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instance Data Pooled"), STAT_CTRLStateTree_PoolWarm, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instance Data Pool High Water Mark"), STAT_CTRLStateTree_PoolHighWaterMark, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Instance Data Pool Unpooled Objects"), STAT_CTRLStateTree_PoolUnpooledObjects, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeInstanceDataPoolSubsystem* UCTRLStateTreeInstanceDataPoolSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeInstanceDataPoolSubsystem>();
+}
+
+bool UCTRLStateTreeInstanceDataPoolSubsystem::IsPoolingEnabled()
+{
+	return UCTRLStateTreeSettings::Get()->InstanceDataPoolSize > 0;
+}
+
+bool UCTRLStateTreeInstanceDataPoolSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLStateTreeInstanceDataPoolSubsystem::Deinitialize()
+{
+	for (FCTRLStateTreeInstanceDataPool const& Pool : Pools)
+	{
+		DEC_DWORD_STAT_BY(STAT_CTRLStateTree_PoolWarm, Pool.NumWarm);
+	}
+	Pools.Empty();
+	Super::Deinitialize();
+}
+
+FCTRLStateTreeInstanceDataPool const* UCTRLStateTreeInstanceDataPoolSubsystem::FindPool(UStateTree const* StateTree) const
+{
+	return Pools.FindByPredicate([StateTree](FCTRLStateTreeInstanceDataPool const& Pool) { return Pool.StateTree == StateTree; });
+}
+
+FCTRLStateTreeInstanceDataPool& UCTRLStateTreeInstanceDataPoolSubsystem::FindOrAddPool(UStateTree const* StateTree)
+{
+	if (FCTRLStateTreeInstanceDataPool* Pool = const_cast<FCTRLStateTreeInstanceDataPool*>(FindPool(StateTree)))
+	{
+		return *Pool;
+	}
+	FCTRLStateTreeInstanceDataPool& Pool = Pools.AddDefaulted_GetRef();
+	Pool.StateTree = StateTree;
+	return Pool;
+}
+
+bool UCTRLStateTreeInstanceDataPoolSubsystem::Acquire(UStateTree const* StateTree, FStateTreeInstanceData& InstanceData)
+{
+	if (!StateTree || !IsPoolingEnabled()) { return false; }
+	FCTRLStateTreeInstanceDataPool& Pool = FindOrAddPool(StateTree);
+	++Pool.NumInUse;
+	if (Pool.NumInUse > Pool.HighWaterMark)
+	{
+		Pool.HighWaterMark = Pool.NumInUse;
+		HighWaterMark = FMath::Max(HighWaterMark, Pool.HighWaterMark);
+		SET_DWORD_STAT(STAT_CTRLStateTree_PoolHighWaterMark, HighWaterMark);
+	}
+
+	if (Pool.NumWarm == 0)
+	{
+		++Pool.NumMisses;
+		INC_DWORD_STAT(STAT_CTRLStateTree_PoolMisses);
+		return false;
+	}
+
+	// the slot keeps the caller's empty storage as a spare for the next Release
+	--Pool.NumWarm;
+	Swap(InstanceData, Pool.Storages[Pool.NumWarm]);
+	++Pool.NumHits;
+	INC_DWORD_STAT(STAT_CTRLStateTree_PoolHits);
+	DEC_DWORD_STAT(STAT_CTRLStateTree_PoolWarm);
+	return true;
+}
+
+void UCTRLStateTreeInstanceDataPoolSubsystem::Release(UStateTree const* StateTree, FStateTreeInstanceData& InstanceData)
+{
+	if (!StateTree || !IsPoolingEnabled())
+	{
+		InstanceData.Reset();
+		return;
+	}
+	FCTRLStateTreeInstanceDataPool& Pool = FindOrAddPool(StateTree);
+	Pool.NumInUse = FMath::Max(0, Pool.NumInUse - 1);
+
+	FStateTreeInstanceStorage const& Storage = InstanceData.GetStorage();
+	int32 NumObjects = 0;
+	for (int32 Index = 0; Index < Storage.Num(); ++Index)
+	{
+		NumObjects += Storage.IsObject(Index) ? 1 : 0;
+	}
+	Pool.NumUnpooledObjects += NumObjects;
+	INC_DWORD_STAT_BY(STAT_CTRLStateTree_PoolUnpooledObjects, NumObjects);
+	InstanceData.Reset();
+
+	if (Pool.NumWarm >= UCTRLStateTreeSettings::Get()->InstanceDataPoolSize) { return; }
+	if (Pool.NumWarm == Pool.Storages.Num())
+	{
+		// only grows until the pool reached its working size
+		Pool.Storages.AddDefaulted();
+	}
+	Swap(InstanceData, Pool.Storages[Pool.NumWarm]);
+	++Pool.NumWarm;
+	INC_DWORD_STAT(STAT_CTRLStateTree_PoolWarm);
+}
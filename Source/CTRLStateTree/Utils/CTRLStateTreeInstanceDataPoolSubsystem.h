@@ -0,0 +1,75 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "StateTreeInstanceData.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CTRLStateTreeInstanceDataPoolSubsystem.generated.h"
+
+class UStateTree;
+
+// Reset instance data storages for one StateTree asset
+USTRUCT()
+struct FCTRLStateTreeInstanceDataPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UStateTree const> StateTree = nullptr;
+
+	// [0, NumWarm) were used before and keep their allocations, the rest are spare empty storages swapped out on acquire
+	UPROPERTY()
+	TArray<FStateTreeInstanceData> Storages;
+
+	int32 NumWarm = 0;
+	// Instances currently running with storage acquired from this pool (hit or miss)
+	int32 NumInUse = 0;
+	int32 HighWaterMark = 0;
+	int32 NumHits = 0;
+	int32 NumMisses = 0;
+	// UObject node instances released with the storages of this asset, these aren't reused
+	int32 NumUnpooledObjects = 0;
+};
+
+/*
+ * Pools FStateTreeInstanceData per StateTree asset across StartLogic/StopLogic of pawn state tree components,
+ * so respawns and restarts reuse the storage (and its allocations) of stopped instances.
+ * Pool size per asset is UCTRLStateTreeSettings::InstanceDataPoolSize.
+ * Note: UObject node instance data (e.g. UCTRLCreateWidgetTaskData) is duplicated by the StateTree on start and
+ * can't be handed out from the pool. Such objects are counted by the "Instance Data Pool Unpooled Objects" stat,
+ * prefer struct instance data for nodes of trees that restart often.
+ */
+UCLASS(DisplayName="StateTree Instance Data Pool Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeInstanceDataPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeInstanceDataPoolSubsystem* Get(UObject const* WorldContextObject);
+	// False with InstanceDataPoolSize 0, callers then skip Acquire/Release and the bookkeeping
+	static bool IsPoolingEnabled();
+
+	// Swaps a pooled storage into InstanceData if one is available. Always pair with Release
+	bool Acquire(UStateTree const* StateTree, FStateTreeInstanceData& InstanceData);
+	// Resets InstanceData and swaps it into the pool if not full; InstanceData is left empty either way
+	void Release(UStateTree const* StateTree, FStateTreeInstanceData& InstanceData);
+
+	FCTRLStateTreeInstanceDataPool const* FindPool(UStateTree const* StateTree) const;
+
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	FCTRLStateTreeInstanceDataPool& FindOrAddPool(UStateTree const* StateTree);
+
+	UPROPERTY(Transient)
+	TArray<FCTRLStateTreeInstanceDataPool> Pools;
+
+	// Highest HighWaterMark of all pools
+	int32 HighWaterMark = 0;
+};
@@ -0,0 +1,102 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeLODSubsystem.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+#include "CTRLStateTree/CTRLStateTreeUtils.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include "GameFramework/Pawn.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeLODSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("LOD Update"), STAT_CTRLStateTree_LODUpdate, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("LOD Components"), STAT_CTRLStateTree_LODComponents, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeLODSubsystem* UCTRLStateTreeLODSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeLODSubsystem>();
+}
+
+bool UCTRLStateTreeLODSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLStateTreeLODSubsystem::Register(UCTRLPawnStateTreeComponent* Component)
+{
+	if (!IsValid(Component)) { return; }
+	Components.AddUnique(Component);
+}
+
+void UCTRLStateTreeLODSubsystem::Unregister(UCTRLPawnStateTreeComponent* Component)
+{
+	if (Components.RemoveSwap(Component) > 0)
+	{
+		Component->ClearLODBand();
+	}
+}
+
+void UCTRLStateTreeLODSubsystem::Deinitialize()
+{
+	Components.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UCTRLStateTreeLODSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCTRLStateTreeLODSubsystem, STATGROUP_CTRLStateTree);
+}
+
+void UCTRLStateTreeLODSubsystem::Tick(float const DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_LODUpdate);
+	SET_DWORD_STAT(STAT_CTRLStateTree_LODComponents, Components.Num());
+
+	auto const* Settings = UCTRLStateTreeSettings::Get();
+	if (Components.IsEmpty() || Settings->LODBands.IsEmpty()) { return; }
+
+	ViewLocations.Reset();
+	UCTRLStateTreeUtils::GetPlayerViewLocations(GetWorld(), ViewLocations);
+	// nothing to score against, keep the current bands
+	if (ViewLocations.IsEmpty()) { return; }
+
+	// nothing is rendered on a dedicated server, so only distance counts there
+	bool const bUseVisibility = GetWorld()->GetNetMode() != NM_DedicatedServer;
+	double const NotRenderedScaleSquared = FMath::Square(static_cast<double>(Settings->NotRenderedDistanceScale));
+
+	for (int32 Index = Components.Num() - 1; Index >= 0; --Index)
+	{
+		UCTRLPawnStateTreeComponent* Component = Components[Index];
+		if (!IsValid(Component))
+		{
+			Components.RemoveAtSwap(Index);
+			continue;
+		}
+
+		AActor const* Actor = IsValid(Component->PawnActor) ? Component->PawnActor.Get() : Component->GetOwner();
+		if (!Actor) { continue; }
+
+		FVector const Location = Actor->GetActorLocation();
+		double DistanceSquared = TNumericLimits<double>::Max();
+		for (FVector const& ViewLocation : ViewLocations)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared(Location, ViewLocation));
+		}
+		if (bUseVisibility && !Actor->WasRecentlyRendered(Settings->RecentlyRenderedTolerance))
+		{
+			DistanceSquared *= NotRenderedScaleSquared;
+		}
+
+		int32 const BandIndex = Settings->GetLODBandIndex(static_cast<float>(FMath::Sqrt(DistanceSquared)));
+		Component->ApplyLODBand(BandIndex, Settings->LODBands[BandIndex]);
+	}
+}
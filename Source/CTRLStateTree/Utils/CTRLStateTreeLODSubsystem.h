@@ -0,0 +1,42 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "CTRLStateTreeLODSubsystem.generated.h"
+
+class UCTRLPawnStateTreeComponent;
+
+/*
+ * Scores all registered pawn state tree components against the player view points in one batched pass per frame,
+ * and assigns each one a tick rate from the LOD bands in UCTRLStateTreeSettings.
+ * Components opt in via bUseSignificanceLOD.
+ */
+UCLASS(DisplayName="StateTree LOD Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeLODSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeLODSubsystem* Get(UObject const* WorldContextObject);
+
+	void Register(UCTRLPawnStateTreeComponent* Component);
+	void Unregister(UCTRLPawnStateTreeComponent* Component);
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UCTRLPawnStateTreeComponent>> Components;
+
+	// scratch, kept to avoid reallocating every frame
+	TArray<FVector> ViewLocations;
+};
@@ -0,0 +1,116 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeLoadingSubsystem.h"
+
+#include "StateTree.h"
+
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+
+#include "Engine/AssetManager.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeLoadingSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("StateTree Warm-up"), STAT_CTRLStateTree_WarmUp, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeLoadingSubsystem* UCTRLStateTreeLoadingSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeLoadingSubsystem>();
+}
+
+bool UCTRLStateTreeLoadingSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLStateTreeLoadingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	for (TSoftObjectPtr<UStateTree> const& StateTree : UCTRLStateTreeSettings::Get()->PreloadStateTrees)
+	{
+		RequestLoad(StateTree);
+	}
+}
+
+void UCTRLStateTreeLoadingSubsystem::Deinitialize()
+{
+	for (TPair<FSoftObjectPath, TSharedPtr<FStreamableHandle>> const& Pair : LoadHandles)
+	{
+		if (Pair.Value.IsValid())
+		{
+			Pair.Value->ReleaseHandle();
+		}
+	}
+	LoadHandles.Empty();
+	WarmedStateTrees.Empty();
+	Super::Deinitialize();
+}
+
+void UCTRLStateTreeLoadingSubsystem::RequestLoad(TSoftObjectPtr<UStateTree> const& StateTree, FStreamableDelegate OnLoaded)
+{
+	if (StateTree.IsNull()) { return; }
+	if (UStateTree* LoadedStateTree = StateTree.Get())
+	{
+		WarmUp(*LoadedStateTree);
+		OnLoaded.ExecuteIfBound();
+		return;
+	}
+
+	// the streamable manager merges requests for the same asset, only the first handle is kept
+	FSoftObjectPath const Path = StateTree.ToSoftObjectPath();
+	TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		Path,
+		FStreamableDelegate::CreateUObject(this, &ThisClass::OnLoaded, Path, MoveTemp(OnLoaded))
+	);
+	if (!LoadHandles.Contains(Path))
+	{
+		LoadHandles.Add(Path, MoveTemp(Handle));
+	}
+}
+
+bool UCTRLStateTreeLoadingSubsystem::IsLoading(TSoftObjectPtr<UStateTree> const& StateTree) const
+{
+	TSharedPtr<FStreamableHandle> const* Handle = LoadHandles.Find(StateTree.ToSoftObjectPath());
+	return Handle && Handle->IsValid() && (*Handle)->IsLoadingInProgress();
+}
+
+void UCTRLStateTreeLoadingSubsystem::OnLoaded(FSoftObjectPath Path, FStreamableDelegate OnLoaded)
+{
+	if (UStateTree* StateTree = Cast<UStateTree>(Path.ResolveObject()))
+	{
+		WarmUp(*StateTree);
+	}
+	else
+	{
+		CTRLST_LOG(Warning, TEXT("Failed to load StateTree %s."), *Path.ToString());
+	}
+	OnLoaded.ExecuteIfBound();
+}
+
+void UCTRLStateTreeLoadingSubsystem::WarmUp(UStateTree& StateTree)
+{
+	if (WarmedStateTrees.Contains(&StateTree)) { return; }
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_WarmUp);
+	WarmedStateTrees.Add(&StateTree);
+
+	if (!StateTree.IsReadyToRun() && !StateTree.Link())
+	{
+		CTRLST_LOG(Warning, TEXT("Failed to link StateTree %s during warm-up."), *GetNameSafe(&StateTree));
+		return;
+	}
+	// otherwise created by the first instance that starts
+	StateTree.GetSharedInstanceData();
+
+	for (FCompactStateTreeState const& State : StateTree.GetStates())
+	{
+		if (State.LinkedAsset)
+		{
+			WarmUp(*const_cast<UStateTree*>(State.LinkedAsset.Get()));
+		}
+	}
+}
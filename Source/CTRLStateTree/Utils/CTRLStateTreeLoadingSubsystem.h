@@ -0,0 +1,49 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Engine/StreamableManager.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "CTRLStateTreeLoadingSubsystem.generated.h"
+
+class UStateTree;
+
+/*
+ * Async loads StateTree assets (with their linked subtrees & node dependencies) through the streamable manager
+ * and warms them up, so the first StartLogic doesn't pay for loading, linking or creating the shared instance data.
+ * Loads UCTRLStateTreeSettings::PreloadStateTrees at world init. Loaded assets stay loaded for the lifetime of the world.
+ */
+UCLASS(DisplayName="StateTree Loading Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeLoadingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeLoadingSubsystem* Get(UObject const* WorldContextObject);
+
+	// Loads & warms up StateTree, then calls OnLoaded. Calls OnLoaded right away if it is already loaded
+	void RequestLoad(TSoftObjectPtr<UStateTree> const& StateTree, FStreamableDelegate OnLoaded = FStreamableDelegate());
+	bool IsLoading(TSoftObjectPtr<UStateTree> const& StateTree) const;
+
+	// Links StateTree (if needed) and creates its shared instance data, including linked subtrees. Done once per asset
+	void WarmUp(UStateTree& StateTree);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	void OnLoaded(FSoftObjectPath Path, FStreamableDelegate OnLoaded);
+
+	// keep the loaded assets referenced
+	TMap<FSoftObjectPath, TSharedPtr<FStreamableHandle>> LoadHandles;
+	TSet<TObjectKey<UStateTree>> WarmedStateTrees;
+};
@@ -0,0 +1,125 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeSleepSubsystem.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTree.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeSleepSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Sleep Update"), STAT_CTRLStateTree_SleepUpdate, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Sleeping Components"), STAT_CTRLStateTree_Sleeping, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Woken Components"), STAT_CTRLStateTree_Woken, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeSleepSubsystem* UCTRLStateTreeSleepSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeSleepSubsystem>();
+}
+
+bool UCTRLStateTreeSleepSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLStateTreeSleepSubsystem::Deinitialize()
+{
+	Sleepers.Empty();
+	WakeHeap.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UCTRLStateTreeSleepSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCTRLStateTreeSleepSubsystem, STATGROUP_CTRLStateTree);
+}
+
+void UCTRLStateTreeSleepSubsystem::Add(UCTRLPawnStateTreeComponent* Component, double const WakeTime)
+{
+	if (!IsValid(Component)) { return; }
+	Sleepers.Add(Component, WakeTime);
+	PushWakeTime(Component, WakeTime);
+}
+
+void UCTRLStateTreeSleepSubsystem::Remove(UCTRLPawnStateTreeComponent const* Component)
+{
+	// heap entries of the component go stale and are skipped when popped
+	Sleepers.Remove(Component);
+	CompactWakeHeap();
+}
+
+bool UCTRLStateTreeSleepSubsystem::IsSleeping(UCTRLPawnStateTreeComponent const* Component) const
+{
+	return Sleepers.Contains(Component);
+}
+
+void UCTRLStateTreeSleepSubsystem::SetWakeTime(UCTRLPawnStateTreeComponent const* Component, double const WakeTime)
+{
+	double* SleeperWakeTime = Sleepers.Find(Component);
+	if (!SleeperWakeTime) { return; }
+	*SleeperWakeTime = WakeTime;
+	PushWakeTime(Component, WakeTime);
+}
+
+void UCTRLStateTreeSleepSubsystem::PushWakeTime(UCTRLPawnStateTreeComponent const* Component, double const WakeTime)
+{
+	if (WakeTime <= 0.) { return; }
+	WakeHeap.HeapPush({Component, WakeTime});
+	CompactWakeHeap();
+}
+
+void UCTRLStateTreeSleepSubsystem::CompactWakeHeap()
+{
+	if (WakeHeap.Num() <= 2 * Sleepers.Num() + 64) { return; }
+	WakeHeap.Reset();
+	for (auto It = Sleepers.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.ResolveObjectPtr())
+		{
+			It.RemoveCurrent();
+			continue;
+		}
+		if (It->Value > 0.)
+		{
+			WakeHeap.Add({It->Key, It->Value});
+		}
+	}
+	WakeHeap.Heapify();
+}
+
+void UCTRLStateTreeSleepSubsystem::Tick(float const DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_SleepUpdate);
+	SET_DWORD_STAT(STAT_CTRLStateTree_Sleeping, Sleepers.Num());
+
+	double const Now = GetWorld()->GetTimeSeconds();
+	ToWake.Reset();
+	while (!WakeHeap.IsEmpty() && WakeHeap.HeapTop().WakeTime <= Now)
+	{
+		FCTRLStateTreeSleeper Sleeper;
+		WakeHeap.HeapPop(Sleeper, EAllowShrinking::No);
+		double const* SleeperWakeTime = Sleepers.Find(Sleeper.Component);
+		// woken in the meantime or rescheduled
+		if (!SleeperWakeTime || *SleeperWakeTime != Sleeper.WakeTime) { continue; }
+		UCTRLPawnStateTreeComponent* Component = Sleeper.Component.ResolveObjectPtr();
+		if (!IsValid(Component))
+		{
+			Sleepers.Remove(Sleeper.Component);
+			continue;
+		}
+		ToWake.Add(Component);
+	}
+	SET_DWORD_STAT(STAT_CTRLStateTree_Woken, ToWake.Num());
+
+	// WakeUp removes from Sleepers
+	for (UCTRLPawnStateTreeComponent* Component : ToWake)
+	{
+		Component->WakeUp();
+	}
+}
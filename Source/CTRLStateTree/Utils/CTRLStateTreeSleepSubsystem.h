@@ -0,0 +1,64 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "CTRLStateTreeSleepSubsystem.generated.h"
+
+class UCTRLPawnStateTreeComponent;
+
+// Entry of the wake time heap. Stale once the sleeper woke or got a new wake time, skipped when popped
+struct FCTRLStateTreeSleeper
+{
+	TObjectKey<UCTRLPawnStateTreeComponent> Component;
+	// world time to wake at
+	double WakeTime = 0.;
+
+	bool operator<(FCTRLStateTreeSleeper const& Other) const { return WakeTime < Other.WakeTime; }
+};
+
+/*
+ * Holds pawn state tree components that went to sleep (see UCTRLPawnStateTreeComponent::bUseSleepMode) with their tick disabled.
+ * Sleepers with a wake time are kept in a heap, so a frame only looks at the ones that are due.
+ * Event senders wake the component themselves (UCTRLPawnStateTreeComponent::SendStateTreeEvent, WakeUpStateTrees),
+ * queued events are not polled.
+ */
+UCLASS(DisplayName="StateTree Sleep Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeSleepSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeSleepSubsystem* Get(UObject const* WorldContextObject);
+
+	void Add(UCTRLPawnStateTreeComponent* Component, double WakeTime);
+	void Remove(UCTRLPawnStateTreeComponent const* Component);
+	void SetWakeTime(UCTRLPawnStateTreeComponent const* Component, double WakeTime);
+	int32 GetNumSleeping() const { return Sleepers.Num(); }
+	bool IsSleeping(UCTRLPawnStateTreeComponent const* Component) const;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	// sleeper -> wake time, 0 to sleep until woken
+	TMap<TObjectKey<UCTRLPawnStateTreeComponent>, double> Sleepers;
+
+	// min-heap by WakeTime, may contain stale entries
+	TArray<FCTRLStateTreeSleeper> WakeHeap;
+	void PushWakeTime(UCTRLPawnStateTreeComponent const* Component, double WakeTime);
+	// drops stale entries once they dominate the heap
+	void CompactWakeHeap();
+
+	// scratch, kept to avoid reallocating every frame
+	TArray<UCTRLPawnStateTreeComponent*> ToWake;
+};
@@ -0,0 +1,156 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#include "CTRLStateTreeStartupSubsystem.h"
+
+#include "CTRLStateTree/CTRLPawnStateTreeComponent.h"
+#include "CTRLStateTree/CTRLStateTree.h"
+#include "CTRLStateTree/CTRLStateTreeSettings.h"
+#include "CTRLStateTree/CTRLStateTreeUtils.h"
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+
+#include "GameFramework/Pawn.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(CTRLStateTreeStartupSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Startup Queue"), STAT_CTRLStateTree_StartupQueue, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Startup Queued"), STAT_CTRLStateTree_StartupQueued, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Startup Started"), STAT_CTRLStateTree_StartupStarted, STATGROUP_CTRLStateTree);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Startup Started Overdue"), STAT_CTRLStateTree_StartupOverdue, STATGROUP_CTRLStateTree);
+
+UCTRLStateTreeStartupSubsystem* UCTRLStateTreeStartupSubsystem::Get(UObject const* WorldContextObject)
+{
+	auto const World = GEngine->GetWorldFromContextObject(WorldContextObject, EGetWorldErrorMode::LogAndReturnNull);
+	if (!World) { return nullptr; }
+	return World->GetSubsystem<UCTRLStateTreeStartupSubsystem>();
+}
+
+bool UCTRLStateTreeStartupSubsystem::DoesSupportWorldType(EWorldType::Type const WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UCTRLStateTreeStartupSubsystem::Deinitialize()
+{
+	Requests.Empty();
+	DeferredRequests.Empty();
+	QueuedComponents.Empty();
+	Super::Deinitialize();
+}
+
+TStatId UCTRLStateTreeStartupSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UCTRLStateTreeStartupSubsystem, STATGROUP_CTRLStateTree);
+}
+
+void UCTRLStateTreeStartupSubsystem::Enqueue(UCTRLPawnStateTreeComponent* Component)
+{
+	if (!IsValid(Component)) { return; }
+	bool bAlreadyQueued = false;
+	QueuedComponents.Add(Component, &bAlreadyQueued);
+	if (bAlreadyQueued) { return; }
+	FCTRLStateTreeStartupRequest Request;
+	Request.Component = Component;
+	Request.QueuedTime = GetWorld()->GetRealTimeSeconds();
+	(bDraining ? DeferredRequests : Requests).Add(Request);
+}
+
+bool UCTRLStateTreeStartupSubsystem::Dequeue(UCTRLPawnStateTreeComponent const* Component)
+{
+	if (QueuedComponents.Remove(Component) == 0) { return false; }
+	// queued at most once, and the order doesn't matter in either array
+	auto const IsComponent = [Component](FCTRLStateTreeStartupRequest const& Request) { return Request.Component == Component; };
+	if (Requests.RemoveSingleSwap(IsComponent, EAllowShrinking::No) == 0)
+	{
+		DeferredRequests.RemoveSingleSwap(IsComponent, EAllowShrinking::No);
+	}
+	return true;
+}
+
+bool UCTRLStateTreeStartupSubsystem::IsQueued(UCTRLPawnStateTreeComponent const* Component) const
+{
+	return QueuedComponents.Contains(Component);
+}
+
+void UCTRLStateTreeStartupSubsystem::Tick(float const DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	SCOPE_CYCLE_COUNTER(STAT_CTRLStateTree_StartupQueue);
+	Requests.Append(MoveTemp(DeferredRequests));
+	DeferredRequests.Reset();
+	SET_DWORD_STAT(STAT_CTRLStateTree_StartupQueued, Requests.Num());
+	Requests.RemoveAll(
+		[this](FCTRLStateTreeStartupRequest const& Request)
+		{
+			if (IsValid(Request.Component)) { return false; }
+			QueuedComponents.Remove(Request.Component.Get());
+			return true;
+		}
+	);
+	// a request the GC nulled out can't be found in the set by its component anymore
+	if (QueuedComponents.Num() != Requests.Num())
+	{
+		QueuedComponents.Reset();
+		for (FCTRLStateTreeStartupRequest const& Request : Requests)
+		{
+			QueuedComponents.Add(Request.Component.Get());
+		}
+	}
+	if (Requests.IsEmpty()) { return; }
+
+	auto const* Settings = UCTRLStateTreeSettings::Get();
+	double const Now = GetWorld()->GetRealTimeSeconds();
+	double const MaxLatency = Settings->MaxStartLatency;
+
+	ViewLocations.Reset();
+	UCTRLStateTreeUtils::GetPlayerViewLocations(GetWorld(), ViewLocations);
+	for (FCTRLStateTreeStartupRequest& Request : Requests)
+	{
+		Request.Priority = 0.;
+		if (ViewLocations.IsEmpty()) { continue; }
+		AActor const* Actor = IsValid(Request.Component->PawnActor) ? Request.Component->PawnActor.Get() : Request.Component->GetOwner();
+		if (!Actor) { continue; }
+		FVector const Location = Actor->GetActorLocation();
+		Request.Priority = TNumericLimits<double>::Max();
+		for (FVector const& ViewLocation : ViewLocations)
+		{
+			Request.Priority = FMath::Min(Request.Priority, FVector::DistSquared(Location, ViewLocation));
+		}
+	}
+
+	// best last: overdue oldest first, then nearest
+	auto IsOverdue = [Now, MaxLatency](FCTRLStateTreeStartupRequest const& Request) { return Now - Request.QueuedTime >= MaxLatency; };
+	Requests.Sort(
+		[&IsOverdue](FCTRLStateTreeStartupRequest const& A, FCTRLStateTreeStartupRequest const& B)
+		{
+			bool const bAOverdue = IsOverdue(A);
+			bool const bBOverdue = IsOverdue(B);
+			if (bAOverdue != bBOverdue) { return bBOverdue; }
+			if (bAOverdue) { return A.QueuedTime > B.QueuedTime; }
+			return A.Priority > B.Priority;
+		}
+	);
+
+	double const BudgetSeconds = Settings->StartupBudgetMs / 1000.;
+	double const StartTime = FPlatformTime::Seconds();
+	int32 NumStarted = 0;
+	int32 NumOverdue = 0;
+	TGuardValue<bool> DrainingGuard(bDraining, true);
+	while (!Requests.IsEmpty())
+	{
+		bool const bOverdue = IsOverdue(Requests.Last());
+		// always start at least one per frame
+		if (!bOverdue && NumStarted > 0 && FPlatformTime::Seconds() - StartTime >= BudgetSeconds) { break; }
+
+		UCTRLPawnStateTreeComponent* Component = Requests.Pop(EAllowShrinking::No).Component;
+		QueuedComponents.Remove(Component);
+		if (!IsValid(Component)) { continue; }
+		Component->StartLogicFromScheduler();
+		++NumStarted;
+		NumOverdue += bOverdue ? 1 : 0;
+	}
+	SET_DWORD_STAT(STAT_CTRLStateTree_StartupStarted, NumStarted);
+	SET_DWORD_STAT(STAT_CTRLStateTree_StartupOverdue, NumOverdue);
+}
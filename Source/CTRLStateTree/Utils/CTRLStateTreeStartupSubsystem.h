@@ -0,0 +1,69 @@
+﻿// SPDX-FileCopyrightText: © 2025 NTY.studio
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "UObject/ObjectKey.h"
+
+#include "CTRLStateTreeStartupSubsystem.generated.h"
+
+class UCTRLPawnStateTreeComponent;
+
+USTRUCT()
+struct FCTRLStateTreeStartupRequest
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TObjectPtr<UCTRLPawnStateTreeComponent> Component = nullptr;
+
+	double QueuedTime = 0.;
+	// squared distance to the nearest player view point, refreshed every frame
+	double Priority = 0.;
+};
+
+/*
+ * Time-sliced StartLogic for pawn state tree components that opted in via bUseStartupScheduler.
+ * Queued starts are drained nearest to a player view point first, within UCTRLStateTreeSettings::StartupBudgetMs per frame.
+ * Requests older than UCTRLStateTreeSettings::MaxStartLatency start regardless of the budget.
+ */
+UCLASS(DisplayName="StateTree Startup Subsystem [CTRL]")
+class CTRLSTATETREE_API UCTRLStateTreeStartupSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	static UCTRLStateTreeStartupSubsystem* Get(UObject const* WorldContextObject);
+
+	void Enqueue(UCTRLPawnStateTreeComponent* Component);
+	// Returns true if Component was queued
+	bool Dequeue(UCTRLPawnStateTreeComponent const* Component);
+	bool IsQueued(UCTRLPawnStateTreeComponent const* Component) const;
+	int32 GetNumQueued() const { return Requests.Num() + DeferredRequests.Num(); }
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual void Deinitialize() override;
+
+protected:
+	virtual bool DoesSupportWorldType(EWorldType::Type const WorldType) const override;
+
+	// sorted every tick, so the order in here doesn't matter
+	UPROPERTY(Transient)
+	TArray<FCTRLStateTreeStartupRequest> Requests;
+
+	// requests enqueued while draining, e.g. by a starting tree, are held here until the next frame
+	UPROPERTY(Transient)
+	TArray<FCTRLStateTreeStartupRequest> DeferredRequests;
+	bool bDraining = false;
+
+	// components in Requests or DeferredRequests, so membership checks don't scan them
+	TSet<TObjectKey<UCTRLPawnStateTreeComponent>> QueuedComponents;
+
+	// scratch, kept to avoid reallocating every frame
+	TArray<FVector> ViewLocations;
+};